@@ -0,0 +1,72 @@
+// multi-threaded buffer pool stress test: every thread requests and
+// releases random pages, and the run reports lookups per second as the
+// thread count grows.
+// build: cmake --build <build> --target bench_buffer_pool
+#include "memory_disk_manager.h"
+#include "storage/buffer_manager/buffer_manager.h"
+#include "config/config.h"
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace db;
+using namespace db::storage;
+
+namespace {
+double Run(size_t threads, page_id_t working_set, std::chrono::milliseconds duration) {
+    MemoryDiskManager disk{working_set};
+    BufferManager bm{ReplacementPolicyType::CLOCK, &disk};
+
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> total{0};
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            uint64_t x = 0x9E3779B97F4A7C15ull * (t + 1);
+            size_t ops = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (int i = 0; i < 256; ++i) {
+                    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+                    page_id_t pid = static_cast<page_id_t>(x % working_set);
+                    Frame* f = bm.request(pid);
+                    bm.release(f->page_id);
+                }
+                ops += 256;
+            }
+            total += ops;
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (auto& w : workers) w.join();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return total / secs;
+}
+}
+
+int main(int argc, char** argv) {
+    auto duration = std::chrono::milliseconds(argc > 1 ? std::stoi(argv[1]) : 500);
+    size_t max_threads = std::max<size_t>(8, std::thread::hardware_concurrency());
+
+    struct Workload { const char* name; page_id_t pages; };
+    const Workload workloads[] = {
+        {"hits (working set fits the pool)", static_cast<page_id_t>(config::BUFFER_POOL_SIZE / 2)},
+        {"misses (working set 4x the pool)", static_cast<page_id_t>(config::BUFFER_POOL_SIZE * 4)},
+    };
+
+    for (const auto& w : workloads) {
+        std::cout << w.name << "\n";
+        for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+            double rate = Run(threads, w.pages, duration);
+            std::cout << "  threads " << std::setw(3) << threads << ": "
+                      << std::fixed << std::setprecision(2)
+                      << rate / 1e6 << " M lookups/s\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,46 @@
+// measures the cost of checksumming and verifying one page.
+// build: cmake --build <build> --target bench_page_checksum
+#include "storage/page/page_checksum.h"
+#include "config/config.h"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace db;
+
+int main(int argc, char** argv) {
+    const size_t iterations = argc > 1 ? std::stoul(argv[1]) : 200000;
+
+    // a working set larger than L1 so every page is not already hot
+    constexpr size_t NUM_PAGES = 64;
+    std::vector<char> pages(NUM_PAGES * config::PAGE_SIZE);
+    std::mt19937 rng{42};
+    for (char& c : pages) c = static_cast<char>(rng());
+
+    using clock = std::chrono::steady_clock;
+
+    auto start = clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        storage::SetPageChecksum(&pages[(i % NUM_PAGES) * config::PAGE_SIZE]);
+    }
+    double set_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+
+    size_t ok = 0;
+    start = clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        ok += storage::VerifyPageChecksum(&pages[(i % NUM_PAGES) * config::PAGE_SIZE]);
+    }
+    double verify_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+
+    double per_page = set_ns / iterations;
+    std::cout << "crc32c implementation: "
+              << (storage::Crc32cHardwareAccelerated() ? "sse4.2" : "slicing-by-8") << "\n"
+              << "page size:             " << config::PAGE_SIZE << " bytes\n"
+              << "set checksum:          " << per_page << " ns/page ("
+              << config::PAGE_SIZE / per_page << " GB/s)\n"
+              << "verify checksum:       " << verify_ns / iterations << " ns/page\n";
+
+    return ok == iterations ? 0 : 1;
+}
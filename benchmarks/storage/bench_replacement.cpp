@@ -0,0 +1,132 @@
+// replays mixed point-lookup and sequential-scan traces against the buffer
+// pool and reports the hit ratio of every replacement policy.
+//
+// lookups hit a hot set (catalog and OLTP pages, 60 pages unless noted)
+// most of the time and a large cold table otherwise. scans read a table
+// several times the pool size front to back, requesting each page once per
+// tuple like the heap iterator does.
+// build: cmake --build <build> --target bench_replacement
+#include "memory_disk_manager.h"
+#include "storage/buffer_manager/buffer_manager.h"
+#include "config/config.h"
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace db;
+using namespace db::storage;
+
+namespace {
+constexpr page_id_t HOT_REGION = 1'000; // the hot set wanders within pages [0, HOT_REGION)
+constexpr page_id_t COLD_FIRST = HOT_REGION;
+constexpr page_id_t COLD_PAGES = 5'000;
+constexpr page_id_t SCAN_FIRST = 100'000;
+constexpr page_id_t SCAN_PAGES = static_cast<page_id_t>(config::BUFFER_POOL_SIZE * 4);
+constexpr int TUPLES_PER_PAGE = 20;
+constexpr int HOT_PERCENT = 90;
+constexpr size_t LOOKUPS = 200'000;
+
+struct Workload {
+    const char* name;
+    size_t scan_every; // lookups between two scans, 0 = no scans
+    size_t hot_moves_every; // lookups between hot set moves, 0 = fixed
+    size_t phase; // if set, scans only run in every other phase of this many lookups
+    page_id_t hot_pages = static_cast<page_id_t>(config::BUFFER_POOL_SIZE * 6 / 10);
+};
+
+struct Result {
+    double overall;
+    double lookups;
+};
+
+struct Access {
+    page_id_t pid;
+    bool lookup;
+};
+
+std::vector<Access> MakeTrace(const Workload& w) {
+    std::vector<Access> trace;
+    uint64_t x = 0x9E3779B97F4A7C15ull;
+    auto next = [&x] {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        return x;
+    };
+
+    for (size_t i = 0; i < LOOKUPS; ++i) {
+        page_id_t hot_first = 0;
+        if (w.hot_moves_every != 0) {
+            hot_first = static_cast<page_id_t>(i / w.hot_moves_every * w.hot_pages % HOT_REGION);
+        }
+        page_id_t pid = static_cast<int>(next() % 100) < HOT_PERCENT
+            ? hot_first + static_cast<page_id_t>(next() % w.hot_pages)
+            : COLD_FIRST + static_cast<page_id_t>(next() % COLD_PAGES);
+        trace.push_back({pid, true});
+
+        bool batch_phase = w.phase == 0 || (i / w.phase) % 2 == 1;
+        if (w.scan_every != 0 && batch_phase && (i + 1) % w.scan_every == 0) {
+            for (page_id_t p = 0; p < SCAN_PAGES; ++p) {
+                for (int t = 0; t < TUPLES_PER_PAGE; ++t) {
+                    trace.push_back({SCAN_FIRST + p, false});
+                }
+            }
+        }
+    }
+    return trace;
+}
+
+Result Replay(ReplacementPolicyType type, const std::vector<Access>& trace) {
+    MemoryDiskManager disk;
+    BufferManager bm{type, &disk};
+
+    size_t lookups = 0;
+    size_t lookup_hits = 0;
+    for (const Access& a : trace) {
+        size_t reads = disk.reads();
+        bm.request(a.pid);
+        bm.release(a.pid);
+        if (a.lookup) {
+            ++lookups;
+            if (disk.reads() == reads) ++lookup_hits;
+        }
+    }
+
+    double misses = static_cast<double>(disk.reads());
+    return {1.0 - misses / trace.size(),
+            static_cast<double>(lookup_hits) / lookups};
+}
+}
+
+int main() {
+    const Workload workloads[] = {
+        {"point lookups only", 0, 0, 0},
+        {"lookups + a scan every 20000 lookups", 20'000, 0, 0},
+        {"lookups + a scan every 2000 lookups", 2'000, 0, 0},
+        {"scan heavy: a scan every 200 lookups", 200, 0, 0},
+        {"hot set moves every 20000 lookups + a scan every 2000", 2'000, 20'000, 0},
+        {"phases of 20000 lookups, every other one with a scan every 200", 200, 0, 20'000},
+        {"hot set of 90 pages + a scan every 2000 lookups", 2'000, 0, 0, 90},
+    };
+    struct Policy { const char* name; ReplacementPolicyType type; };
+    const Policy policies[] = {
+        {"CLOCK", ReplacementPolicyType::CLOCK},
+        {"LRU-2", ReplacementPolicyType::LRU_K},
+        {"2Q", ReplacementPolicyType::TWO_Q},
+        {"ARC", ReplacementPolicyType::ARC},
+    };
+
+    std::cout << "pool " << config::BUFFER_POOL_SIZE << " frames, scans of "
+              << SCAN_PAGES << " pages\n";
+    for (const auto& w : workloads) {
+        std::vector<Access> trace = MakeTrace(w);
+        std::cout << w.name << " (" << trace.size() << " requests)\n";
+        for (const auto& p : policies) {
+            Result r = Replay(p.type, trace);
+            std::cout << "  " << std::left << std::setw(6) << p.name << std::right
+                      << std::fixed << std::setprecision(1)
+                      << " hit ratio " << std::setw(5) << r.overall * 100 << "%"
+                      << "   lookups " << std::setw(5) << r.lookups * 100 << "%\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+#pragma once
+// in-memory IDiskManager shared by the buffer pool benchmarks, so they
+// measure the pool and not the disk
+#include "storage/disk_manager/idisk_manager.h"
+#include "storage/page/page_checksum.h"
+#include "config/config.h"
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace db::storage {
+class MemoryDiskManager : public IDiskManager {
+public:
+    MemoryDiskManager() = default;
+    explicit MemoryDiskManager(page_id_t num_pages) {
+        for (page_id_t pid = 0; pid < num_pages; ++pid) {
+            page(pid);
+        }
+    }
+
+    void ReadPage(page_id_t pid, char* out) override {
+        std::lock_guard<std::mutex> lock{mu_};
+        std::memcpy(out, page(pid).data(), config::PAGE_SIZE);
+        reads_.fetch_add(1, std::memory_order_relaxed);
+    }
+    void WritePage(page_id_t pid, const char* data) override {
+        std::lock_guard<std::mutex> lock{mu_};
+        std::memcpy(page(pid).data(), data, config::PAGE_SIZE);
+    }
+    page_id_t AllocatePage() override { return 0; }
+    void DeallocatePage(page_id_t) override {}
+    void Sync() override {}
+
+    // pages read so far, i.e. buffer pool misses
+    size_t reads() const { return reads_.load(std::memory_order_relaxed); }
+
+private:
+    // pages are created on first use, stamped with their id
+    std::vector<char>& page(page_id_t pid) {
+        auto [it, inserted] = pages_.try_emplace(pid);
+        if (inserted) {
+            it->second.assign(config::PAGE_SIZE, 0);
+            std::memcpy(it->second.data(), &pid, sizeof(pid));
+            SetPageChecksum(it->second.data());
+        }
+        return it->second;
+    }
+
+    std::mutex mu_;
+    std::unordered_map<page_id_t, std::vector<char>> pages_;
+    std::atomic<size_t> reads_{0};
+};
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "storage/buffer_manager/buffer_manager.h"
+#include "config/config.h"
+
+namespace db::access {
+using page_id_t = db::storage::page_id_t;
+
+// free space of a page in steps of FSM_CATEGORY_BYTES, rounded down, so a
+// page of category c has at least c * FSM_CATEGORY_BYTES bytes free
+inline constexpr size_t FSM_CATEGORY_BYTES = config::PAGE_SIZE / 256;
+// entries per FSM page, a power of two for the max-tree
+inline constexpr uint32_t FSM_SLOTS = 1024;
+inline constexpr uint32_t FSM_MAGIC = 0x314d5346; // "FSM1"
+
+// layout of an FSM page: this header, FSM_SLOTS page ids, then the
+// max-tree of 2 * FSM_SLOTS category bytes. node 1 is the maximum of the
+// page, nodes FSM_SLOTS + i the categories of the entries.
+struct FsmPageHeader {
+    uint32_t magic;
+    uint32_t count; // entries in use: leaf pages in the root, heap pages in a leaf
+    page_id_t last_page_id; // root only: end of the heap chain
+    uint32_t reserved;
+};
+static_assert(sizeof(FsmPageHeader) + FSM_SLOTS * (sizeof(page_id_t) + 2) <= config::PAGE_DATA_SIZE);
+
+// a heap page found in the map, and where its entry is
+struct FsmSlot {
+    uint32_t index;
+    page_id_t page_id;
+    page_id_t leaf_page_id; // the FSM page holding the entry
+};
+
+// free space map of a heap file: one category byte per heap page, kept in
+// pages of the file itself. a root page lists up to FSM_SLOTS leaf pages,
+// each listing up to FSM_SLOTS heap pages, and every FSM page carries a
+// binary max-tree over its entries. finding a page with room takes two
+// page latches and O(log n) compares.
+//
+// the map is a hint: inserts correct an entry that promised too much.
+// the root also records the last page of the heap chain, so appending a
+// page does not walk the chain. latch order: root, heap pages, leaf.
+class FreeSpaceMap {
+public:
+    FreeSpaceMap() = default;
+    FreeSpaceMap(storage::BufferManager* bm, const config::uuid_t& file_id, page_id_t root_page_id);
+
+    // a new map of the heap pages `pages` (page id, free bytes) in chain
+    // order; the last one is the end of the chain. returns the root.
+    static page_id_t Build(storage::BufferManager* bm, const config::uuid_t& file_id,
+                           const std::vector<std::pair<page_id_t, size_t>>& pages);
+    // whether `page_id` is the root of a map
+    static bool IsMap(storage::BufferManager* bm, page_id_t page_id);
+
+    // a page whose category promises `len` free bytes; nullopt if none
+    std::optional<FsmSlot> Find(size_t len);
+    // sets the free bytes of a page found by Find(). the root is only
+    // latched if the maximum of the entry's leaf changes.
+    void Update(const FsmSlot& slot, size_t free);
+
+    // runs `append(last page)` with the root latched, so the heap file is
+    // extended by one session at a time. `append` returns the page it
+    // linked after the last one and its free bytes, or nullopt if it did
+    // not need one. a linked page is entered into the map and becomes the
+    // last page; once the map is full, pages are still linked but only
+    // filled while they are the last.
+    template <typename Fn> void Append(Fn&& append);
+
+    page_id_t GetPageId() const { return _root_page_id; }
+
+private:
+    void Add(char* root, page_id_t page_id, size_t free); // root latched
+
+    storage::BufferManager* _bm = nullptr;
+    config::uuid_t _file_id{};
+    page_id_t _root_page_id = INVALID_PAGE_ID;
+};
+
+template <typename Fn>
+void FreeSpaceMap::Append(Fn&& append) {
+    auto root = _bm->write_page(_root_page_id);
+    auto* hdr = reinterpret_cast<FsmPageHeader*>(root.data());
+    std::optional<std::pair<page_id_t, size_t>> linked = append(hdr->last_page_id);
+    if (!linked.has_value()) return;
+
+    hdr->last_page_id = linked->first;
+    Add(root.data(), linked->first, linked->second);
+    root.mark_dirty();
+}
+}
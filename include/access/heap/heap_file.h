@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <optional>
 #include "access/record.h"
+#include "access/heap/free_space_map.h"
 #include "storage/buffer_manager/buffer_manager.h"
 #include "storage/disk_manager/disk_manager.h"
 #include "storage/page/slotted_page.h"
@@ -19,6 +20,9 @@ using page_id_t = db::storage::page_id_t;
 
 struct alignas(8) HeapPageHeader {
     page_id_t next_page_id;
+    // first page only: root of the free space map, or INVALID_PAGE_ID
+    // until the first insert builds it
+    page_id_t fsm_page_id;
 };
 static_assert(sizeof(HeapPageHeader) % 8 == 0);
 
@@ -30,8 +34,12 @@ public:
                         page_id_t first_page_id);
     HeapFile() = default;
     
-    std::optional<RID> Insert(const char* data, size_t len);
-    std::optional<Record> Get(const RID& rid);
+    // `ring` lets bulk loads and scans recycle a few private frames
+    // instead of flooding the shared buffer pool. the free space map
+    // picks the page; only its pages are read besides the one written.
+    std::optional<RID> Insert(const char* data, size_t len,
+                              db::storage::BufferRing* ring = nullptr);
+    std::optional<Record> Get(const RID& rid, db::storage::BufferRing* ring = nullptr);
     bool Update(const char* new_data, size_t len, const RID& rid);
     bool Delete(const RID& rid);
 
@@ -40,7 +48,7 @@ public:
     page_id_t GetPageId() const { return _first_page_id; };
 
     // iterator
-    HeapIterator begin();   
+    HeapIterator begin(db::storage::BufferRing* ring = nullptr);
     HeapIterator end();
 
     // factory
@@ -55,10 +63,14 @@ public:
     static void InitHeapPage(char* raw_page_data);
 
 private:
+    // the file's free space map, built from the page chain the first time
+    FreeSpaceMap GetFreeSpaceMap();
+
     BufferManager* _bm;
     DiskManager* _dm;
     file_id_t _file_id;
     page_id_t _first_page_id;
+    page_id_t _fsm_page_id = INVALID_PAGE_ID;
 
     friend class HeapIterator;
 };
@@ -13,7 +13,8 @@ public:
     HeapIterator(HeapFile* heap,
                  page_id_t page,
                  uint16_t slot,
-                 bool has_next);
+                 bool has_next,
+                 db::storage::BufferRing* ring = nullptr);
     HeapIterator() = default;
     bool HasNext();
     Record Next();
@@ -29,7 +30,10 @@ private:
     page_id_t _curr_page;
     uint16_t _curr_slot;
     bool _has_next;
+    db::storage::BufferRing* _ring = nullptr;
+    page_id_t _readahead_end = 0; // first page not prefetched yet
 
     void Advance();
+    void ReadAhead(page_id_t next);
 };
 }
\ No newline at end of file
@@ -1,12 +1,43 @@
 #pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 namespace db::config {
     using uuid_t = std::array<uint8_t, 16>;
     inline constexpr size_t PAGE_SIZE = 8192; // 8kB
-    inline constexpr size_t BUFFER_POOL_SIZE = 100;
+    inline constexpr size_t PAGE_CHECKSUM_SIZE = 4; // crc32c trailer of every page
+    inline constexpr size_t PAGE_DATA_SIZE = PAGE_SIZE - PAGE_CHECKSUM_SIZE; // usable by page layouts
+    inline constexpr size_t BUFFER_POOL_SIZE = 100; // default frames per BufferManager
+    inline constexpr size_t HUGE_PAGE_SIZE = size_t{2} << 20; // pools at least this big ask for THP
+    inline constexpr size_t BUFFER_POOL_SHARDS = 16; // page table partitions, each with its own latch
+    inline constexpr size_t BUFFER_RING_SIZE = 32; // frames a bulk scan or load recycles
+    inline constexpr uint64_t CORRELATED_REFERENCE_PERIOD = 8; // LRU-K/ARC: references within this many ticks count once
+    inline constexpr size_t LRU_K = 2; // references remembered per page by LRUKPolicy
+    inline constexpr size_t LRU_K_RETAINED_PERCENT = 100; // histories kept for evicted pages, relative to the pool
+    inline constexpr size_t TWO_Q_KIN_PERCENT = 25; // share of the pool for first-time pages (A1in)
+    inline constexpr size_t TWO_Q_KOUT_PERCENT = 50; // ghost entries (A1out), relative to the pool
+    inline constexpr size_t HEAP_READAHEAD_PAGES = 16; // pages a sequential heap scan prefetches, below BUFFER_RING_SIZE
+    inline constexpr size_t BGWRITER_DELAY_MS = 200; // pause between two background writer rounds
+    inline constexpr size_t DELETE_DATABASE_WAIT_MS = 100; // pins DeleteDatabase waits out before it refuses
+    inline constexpr size_t BGWRITER_MAX_PAGES = 100; // I/O budget: pages written per round at most
+    inline constexpr size_t BGWRITER_LOOKAHEAD_PERCENT = 25; // upcoming victims inspected per round, relative to the pool
+    inline constexpr size_t OPTIMISTIC_READ_ATTEMPTS = 3; // before read_optimistic() latches the page instead
+    inline constexpr size_t OPTIMISTIC_TOUCH_INTERVAL = 64; // optimistic reads of a page between two policy references
+    inline constexpr size_t TRACE_BUFFER_RECORDS = 4096; // trace records buffered between two writes
+    inline constexpr size_t WARMUP_BATCH_PAGES = 32; // pages per ReadPages call when reloading a warm set
+    inline constexpr size_t DATABASE_RESERVED_PERCENT = 50; // of a shared pool, split evenly among its databases
+    inline constexpr size_t FAIR_SHARE_LOOKAHEAD = 16; // upcoming victims searched for one outside a database's reserve
+    inline constexpr bool VERIFY_PAGE_CHECKSUMS = true; // default for BufferManager reads
+    inline constexpr size_t MMAP_RESERVE_SIZE = size_t{16} << 30; // 16 GB of address space
+    inline constexpr size_t MMAP_READAHEAD_PAGES = 32; // MADV_WILLNEED window on sequential reads
+    inline constexpr size_t EXTENT_MIN_PAGES = 8; // first extent reserved for a file
+    inline constexpr size_t EXTENT_MAX_PAGES = 64; // extents double up to this size
     inline constexpr std::string DATA_PATH = "data/";
     inline uint32_t DB_MAGIC = 0xDBDBDBDB;
+    inline constexpr uint32_t ALLOC_MAP_MAGIC = 0xA110CA7E;
+    inline constexpr uint32_t DISK_FORMAT_VERSION = 2; // 1: flat page array, 2: allocation maps
+    inline constexpr uint32_t COMPRESSED_PAGE_MAGIC = 0xC0DEC0DE;
+    inline constexpr size_t COMPRESSION_BLOCK_SIZE = 4096; // filesystem block; unit of space saved
 }
-
-   
\ No newline at end of file
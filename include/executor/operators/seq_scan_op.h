@@ -4,6 +4,8 @@
 #include "model/relation.h"
 
 namespace db::executor {
+// scans through a private BufferRing, so a large table does not evict
+// the catalog and other hot pages from the shared pool
 class SeqScanOp : public Operator {
 public:
     explicit SeqScanOp(model::Relation& rel);
@@ -14,5 +16,6 @@ public:
 private:
     model::Relation& _rel;
     HeapIterator _iter;
+    storage::BufferRing _ring;
 };
 }
\ No newline at end of file
@@ -17,8 +17,9 @@ namespace db::model {
 class Relation {
 public:
     explicit Relation(HeapFile hf);
-    std::optional<RID> InsertRaw(std::span<const uint8_t> bytes, size_t len);
-    HeapIterator Begin();
+    std::optional<RID> InsertRaw(std::span<const uint8_t> bytes, size_t len,
+                                 storage::BufferRing* ring = nullptr);
+    HeapIterator Begin(storage::BufferRing* ring = nullptr);
     virtual Tuple Decode(const Record& rec) const  = 0;
 protected:
     HeapFile _hf;
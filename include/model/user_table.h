@@ -17,7 +17,9 @@ namespace db::model {
 class UserTable : public Relation {
 public:
     explicit UserTable(HeapFile hf, std::vector<ColumnInfo> schema, table_id_t table_id);
-    std::optional<RID> Insert(const std::vector<common::Value> values);
+    // bulk loads pass a BufferRing so they do not flush the buffer pool
+    std::optional<RID> Insert(const std::vector<common::Value> values,
+                              storage::BufferRing* ring = nullptr);
     Tuple Decode(const Record& rec) const override;
 private:
     std::vector<ColumnInfo> _schema;
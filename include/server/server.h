@@ -2,20 +2,49 @@
 
 #include <unordered_map>
 #include <memory>
+#include <optional>
+#include "storage/buffer_manager/background_writer.h"
+#include "storage/buffer_manager/buffer_manager.h"
 #include "storage/disk_manager/disk_manager.h"
+#include "config/config.h"
 
 namespace db::server {
 
+// all open databases share one buffer pool of `pool_size` frames. each
+// gets a view of it, which callers use instead of a BufferManager of
+// their own. a background writer trickles the pool's dirty pages to disk.
 class DbServer {
 public:
-    DbServer() = default;
+    explicit DbServer(size_t pool_size = config::BUFFER_POOL_SIZE);
+    // flushes every open database and saves its warm set
+    ~DbServer();
     void Init();
     storage::DiskManager* OpenDatabase(const std::string& db_name);
     bool CreateDatabase(const std::string& db_name);
     bool DeleteDatabase(const std::string& db_name);
 
+    // the database's view of the shared pool; nullptr if it is not open
+    storage::BufferManager* GetBufferManager(const std::string& db_name);
+    // counters of the whole pool; per database, see stats() of its view
+    storage::BufferPoolStats PoolStats() const { return _pool.stats(); }
+
+    // the warm set of a database's pages, kept in <db_name>.warm next to
+    // its file. saved on shutdown and reloaded when the database is
+    // opened; both return the number of pages, 0 if it is not open.
+    size_t SaveWarmSet(const std::string& db_name);
+    size_t WarmUp(const std::string& db_name);
+
 private:
+    storage::DiskManager* Attach(const std::string& db_name,
+                                 std::unique_ptr<storage::DiskManager> dm);
+
+    storage::BufferManager _pool;
     std::unordered_map<std::string, 
                         std::unique_ptr<storage::DiskManager>> _cache;
+    // destroyed before the disk managers and the pool they refer to
+    std::unordered_map<std::string,
+                        std::unique_ptr<storage::BufferManager>> _buffers;
+    // cleans the pool ahead of eviction; stopped before the final flush
+    std::optional<storage::BackgroundWriter> _writer;
 };
 }
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "storage/buffer_manager/buffer_manager.h"
+#include "config/config.h"
+
+namespace db::storage {
+// trickles dirty pages to disk ahead of eviction. every `delay` a worker
+// thread calls BufferManager::write_behind(max_pages), so a foreground
+// request() usually finds a clean victim and does not wait for a write.
+// must be destroyed before the buffer manager it writes for.
+class BackgroundWriter {
+public:
+    explicit BackgroundWriter(BufferManager* bm,
+                              std::chrono::milliseconds delay
+                                  = std::chrono::milliseconds{config::BGWRITER_DELAY_MS},
+                              size_t max_pages = config::BGWRITER_MAX_PAGES);
+    BackgroundWriter(const BackgroundWriter& other) = delete;
+    BackgroundWriter& operator=(const BackgroundWriter& other) = delete;
+
+    // stops the worker after the round in progress
+    ~BackgroundWriter();
+
+    // pages written so far
+    size_t pages_written() const { return pages_written_; }
+
+private:
+    void Run();
+
+    BufferManager* bm_;
+    std::chrono::milliseconds delay_;
+    size_t max_pages_;
+    std::atomic<size_t> pages_written_ = 0;
+
+    std::mutex mu_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::thread worker_;
+};
+}
@@ -1,34 +1,279 @@
 #pragma once
+#include <atomic>
+#include <map>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "storage/buffer_manager/buffer_ring.h"
+#include "storage/buffer_manager/buffer_stats.h"
+#include "storage/buffer_manager/buffer_trace.h"
+#include "storage/buffer_manager/database_disks.h"
 #include "storage/buffer_manager/free_list.h"
 #include "storage/buffer_manager/frame.h"
+#include "storage/buffer_manager/page_guard.h"
 #include "storage/buffer_manager/replacement_policies/replacement.h"
 #include "storage/disk_manager/idisk_manager.h"
+#include "config/config.h"
 
 
 namespace db::storage {
 
-enum class ReplacementPolicyType { CLOCK };
+// CLOCK: second chance, lock-free. LRU_K, TWO_Q and ARC resist sequential
+// scans at the cost of a policy latch per hit; ARC also tunes itself
+// between recency and frequency.
+enum class ReplacementPolicyType { CLOCK, LRU_K, TWO_Q, ARC };
+
+// where an optimistic reader last found a page, so that it can skip the
+// page table next time. owned by one thread; frame == nullptr until the
+// first read.
+struct PageHint {
+    page_id_t page_id = INVALID_PAGE_ID;
+    Frame* frame = nullptr;
+    uint32_t reads = 0; // optimistic reads since the policy last saw one
+
+    explicit PageHint(page_id_t pid) : page_id{pid} {}
+};
+
+// thread-safe buffer pool. the page table is split into
+// BUFFER_POOL_SHARDS shards with their own latch, pin counts are atomic,
+// and eviction only latches the shard of the victim page.
+//
+// one pool can serve several databases: create it without a disk manager
+// and give each database a view. a view is a BufferManager that takes
+// the database's own page ids and shares the frames, the page table and
+// the replacement policy of the pool.
 class BufferManager {
 public:
-    BufferManager(ReplacementPolicyType type, IDiskManager* dm);
+    // `pool_size` frames are carved out of one anonymous mapping that is
+    // released when the buffer manager is destroyed. with `dm` == nullptr
+    // the pool is shared and pages are only reached through views.
+    BufferManager(ReplacementPolicyType type, IDiskManager* dm,
+                  size_t pool_size = config::BUFFER_POOL_SIZE);
+
+    // view of the shared `pool` for the database on `dm`. the pool must
+    // outlive the view; destroying the view drops the database's pages
+    // from the pool without writing them, so flush_all() first. it waits
+    // for pages that are still pinned; see has_pinned_pages().
+    BufferManager(BufferManager& pool, IDiskManager* dm);
+    BufferManager(const BufferManager& other) = delete;
+    BufferManager& operator=(const BufferManager& other) = delete;
+    ~BufferManager();
 
-    Frame* request(page_id_t pid);
+    // a miss requested through `ring` recycles one of the ring's frames
+    // instead of taking one from the shared pool
+    Frame* request(page_id_t pid, BufferRing* ring = nullptr);
     void release(page_id_t pid);
+
+    // request() plus the frame latch in shared or exclusive mode; the
+    // guard unlatches and releases the page when it goes away
+    ReadPageGuard read_page(page_id_t pid, BufferRing* ring = nullptr);
+    WritePageGuard write_page(page_id_t pid, BufferRing* ring = nullptr);
+
+    // optimistic read: runs `fn(const char* data)` on the cached page
+    // without pinning or latching it, then checks that no writer or
+    // eviction touched the frame meanwhile. returns false if one did, or
+    // if the page is not cached; the result of `fn` must then be thrown
+    // away. `fn` may see a half-written page, so it should only copy data
+    // out and must bounds-check any offset it reads from the page.
+    template <typename Fn> bool try_read_optimistic(PageHint& hint, Fn&& fn);
+
+    // try_read_optimistic() up to OPTIMISTIC_READ_ATTEMPTS times, then
+    // once more under a ReadPageGuard, loading the page if needed
+    template <typename Fn> void read_optimistic(PageHint& hint, Fn&& fn);
+
+    // allocates a page (for `file_id` if given) and maps it to a zeroed
+    // frame without reading it from disk. the page is returned dirty and
+    // write-latched.
+    WritePageGuard new_page(BufferRing* ring = nullptr);
+    WritePageGuard new_page(const config::uuid_t& file_id, BufferRing* ring = nullptr);
+
+    // starts reading pages [first, first + n) in the background. pages
+    // that are cached or already being read are skipped. a completed read
+    // is cached unpinned, and request() waits for a read in flight instead
+    // of issuing its own. only a hint: stops early if every frame is
+    // pinned. with `ring`, the pages are read into the ring's frames.
+    void prefetch(page_id_t first, size_t n, BufferRing* ring = nullptr);
     void mark_dirty(Frame* frame);
+
+    // warm set: save_warm_set() writes the ids of the cached pages to
+    // `path`, pages the policy saw referenced first, then hottest first
+    // in the policy's order. warm_up() reloads them in page order with
+    // batched reads on a background thread, as prefetch() does, into free
+    // frames only. returns the number of pages it reads; 0 if there is
+    // no warm set at `path`.
+    size_t save_warm_set(const std::string& path);
+    size_t warm_up(const std::string& path);
+
+    // every dirty page with the sequence number of the change that first
+    // dirtied it since its last write-back, in page order. a checkpoint
+    // needs the oldest of these; once there is a log this is the recLSN.
+    std::vector<std::pair<page_id_t, uint64_t>> dirty_page_table() const;
+
+    // writes every dirty page and syncs. takes each frame latch in shared
+    // mode, so do not call it while holding a WritePageGuard.
     void flush_all();
+
+    // writes back up to `max_pages` dirty, unpinned pages among the next
+    // BGWRITER_LOOKAHEAD_PERCENT of the pool the policy would evict, so
+    // eviction finds them clean. returns the number of pages written.
+    size_t write_behind(size_t max_pages);
     void pin(Frame* f);
     void unpin(Frame* f);
 
+    // pages are checksummed when written back. verifying on read can be
+    // turned off, e.g. to salvage data from a damaged file.
+    void set_verify_checksums(bool enabled);
+
+    size_t pool_size() const { return shared_ ? shared_->pool_size() : pool_.size(); }
+
+    // whether any page is pinned, e.g. by a guard; for a view, any page
+    // of its database
+    bool has_pinned_pages() const;
+
+    // counters since construction; cheap enough to poll. for a view they
+    // count the database's pages only, and `frames` is the number of
+    // frames holding them.
+    BufferPoolStats stats() const;
+
+    // records every request() and release() to a trace file at `path`
+    // until stop_trace(), for replaying it offline with trace_replay.
+    // costs a latch per call while active.
+    void start_trace(const std::string& path) { (shared_ ? shared_->trace_ : trace_).start(path); }
+    void stop_trace() { (shared_ ? shared_->trace_ : trace_).stop(); }
+
 private:
-    Frame* evict();
+    // one cache line per shard, so the latches and counters of
+    // neighbouring shards do not false-share
+    struct alignas(64) PageTableShard {
+        std::mutex mu;
+        std::unordered_map<page_id_t, Frame*> map;
+        std::unordered_map<page_id_t, std::shared_future<void>> loading; // reads and eviction writes in flight
+        std::unordered_map<page_id_t, std::shared_future<void>> writing; // write-backs in flight
+        std::map<page_id_t, uint64_t> dirty; // dirty page -> first-dirtied sequence number
+        std::atomic<uint64_t> hits = 0; // counted per shard to keep the hit path contention-free
+        std::atomic<uint64_t> misses = 0;
+    };
+
+    PageTableShard& shard_for(page_id_t pid);
+    void map_arena(size_t pool_size);
+
+    // a view's page ids in the pool and back; unchanged for a pool
+    page_id_t to_pool(page_id_t pid) const;
+    page_id_t from_pool(page_id_t pid) const { return shared_ ? DatabaseDisks::PageOf(pid) : pid; }
+
+    // returns an unmapped frame for `pid` pinned once by the caller, taken
+    // from the free list or evicted from the pool
+    Frame* evict(page_id_t pid);
+    Frame* ring_victim(BufferRing& ring, bool& recycled, page_id_t pid);
+    bool protected_victim(Frame* victim, page_id_t pid);
+    Frame* find_cached(page_id_t pid); // unpinned; counts as a reference
+    bool try_claim(Frame* victim);
+    void discard(Frame* f);
+    WritePageGuard map_new_page(page_id_t pid, BufferRing* ring);
+    void finish_prefetch(page_id_t pid, Frame* f, bool recycled, std::exception_ptr err);
+
     void read(page_id_t pid, Frame* f);
     void flush(Frame* f);
+    size_t write_back(const std::vector<Frame*>& pinned);
+    void set_dirty(PageTableShard& shard, Frame* f, page_id_t pid); // shard latched
+
+    // shared pools only: per-database counters and views going away
+    void count(page_id_t pid, std::atomic<uint64_t> DatabaseDisks::Slot::*counter, uint64_t n = 1);
+    BufferPoolStats database_stats(uint32_t slot) const;
+    void drop_database(uint32_t slot);
+    bool has_pinned_pages(std::optional<uint32_t> slot) const;
+    void flush_dirty(std::optional<uint32_t> slot);
+    size_t save_warm_set(const std::string& path, std::optional<uint32_t> slot);
+    size_t warm_up_pages(const std::vector<page_id_t>& pages);
 
-    std::unordered_map<page_id_t, Frame*> page_table_;
+    // a page a warm-up reads into a free frame
+    struct WarmupLoad {
+        page_id_t pid;
+        Frame* frame;
+        std::shared_ptr<std::promise<void>> done;
+    };
+    void run_warmups();
+
+    char* arena_ = nullptr; // page data of all frames, frame i at i * PAGE_SIZE
+    size_t arena_len_ = 0;
+    std::unique_ptr<PageTableShard[]> page_table_;
+    size_t num_shards_;
     std::vector<Frame> pool_;
     std::vector<Frame*> frame_ptrs_;   // used by replacement policy
     FreeList free_list_;
     std::unique_ptr<IReplacementPolicy> policy_;
     IDiskManager* disk_;
+    std::atomic<bool> verify_checksums_ = config::VERIFY_PAGE_CHECKSUMS;
+
+    std::mutex prefetch_mu_;
+    std::condition_variable prefetch_cv_;
+    size_t prefetches_ = 0; // reads in flight, waited for by the destructor
+
+    // warm-ups wait in a queue for one worker, started by the first
+    std::mutex warmup_mu_;
+    std::condition_variable warmup_cv_;
+    std::deque<std::vector<WarmupLoad>> warmups_;
+    bool stopping_ = false;
+    std::thread warmup_;
+
+    // metrics, all updated with relaxed atomics
+    std::atomic<uint64_t> evictions_ = 0;
+    std::atomic<uint64_t> dirty_evictions_ = 0;
+    std::atomic<uint64_t> reads_ = 0;
+    std::atomic<uint64_t> prefetched_ = 0;
+    std::atomic<uint64_t> writes_ = 0;
+    std::atomic<uint64_t> new_pages_ = 0;
+    std::atomic<uint64_t> dirty_seq_ = 0;
+    AtomicHistogram miss_latency_;
+    AtomicHistogram latch_wait_;
+    BufferTrace trace_;
+
+    std::unique_ptr<DatabaseDisks> databases_; // set in a shared pool
+    BufferManager* shared_ = nullptr;          // set in a view
+    uint32_t slot_ = 0;                        // the view's database in the pool
 };
+
+template <typename Fn>
+bool BufferManager::try_read_optimistic(PageHint& hint, Fn&& fn) {
+    // the page table latch and the policy are only visited when the hint
+    // is stale and every OPTIMISTIC_TOUCH_INTERVAL reads, so the policy
+    // still sees the page as hot
+    page_id_t pid = to_pool(hint.page_id);
+    Frame* f = hint.frame;
+    if (f == nullptr || f->page_id.load(std::memory_order_acquire) != pid
+        || ++hint.reads >= config::OPTIMISTIC_TOUCH_INTERVAL) {
+        f = find_cached(hint.page_id);
+        hint.frame = f;
+        hint.reads = 0;
+        if (f == nullptr) return false;
+    }
+
+    uint64_t version = f->version.load(std::memory_order_acquire);
+    if (version % 2 != 0) return false; // being written
+    if (f->page_id.load(std::memory_order_acquire) != pid) return false;
+
+    fn(static_cast<const char*>(f->data));
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return f->version.load(std::memory_order_relaxed) == version;
+}
+
+template <typename Fn>
+void BufferManager::read_optimistic(PageHint& hint, Fn&& fn) {
+    for (size_t i = 0; i < config::OPTIMISTIC_READ_ATTEMPTS; ++i) {
+        if (try_read_optimistic(hint, fn)) return;
+        if (hint.frame == nullptr) break; // not cached
+    }
+    ReadPageGuard page = read_page(hint.page_id);
+    hint.frame = page.frame_;
+    fn(page.data());
+}
 }
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "storage/buffer_manager/frame.h"
+#include "config/config.h"
+
+namespace db::storage {
+// buffer access strategy for bulk scans and bulk loads: a small private
+// ring of frames. a miss requested through a ring reuses the frame the ring
+// loaded `size` misses ago if it still holds that page and is unpinned, so
+// the operation recycles its own pages instead of evicting the shared
+// working set. only the first lap takes frames from the pool.
+//
+// not thread-safe: one ring per scan or load.
+class BufferRing {
+public:
+    explicit BufferRing(size_t size = config::BUFFER_RING_SIZE)
+        : frames_(size == 0 ? 1 : size, nullptr),
+          pages_(frames_.size(), INVALID_PAGE_ID) {}
+
+    size_t size() const { return frames_.size(); }
+
+private:
+    friend class BufferManager;
+
+    // true if the ring loaded `pid` into `f`
+    bool holds(const Frame* f, page_id_t pid) const {
+        for (size_t i = 0; i < frames_.size(); ++i) {
+            if (frames_[i] == f && pages_[i] == pid) return true;
+        }
+        return false;
+    }
+
+    // the next slot now holds `pid` in `f`
+    void loaded(Frame* f, page_id_t pid) {
+        frames_[next_] = f;
+        pages_[next_] = pid;
+        next_ = (next_ + 1) % frames_.size();
+    }
+
+    std::vector<Frame*> frames_;
+    std::vector<page_id_t> pages_; // page each frame was loaded with
+    size_t next_ = 0;
+};
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace db::storage {
+// latencies in power-of-two buckets of microseconds: bucket 0 counts
+// samples below 1 us, bucket i samples in [2^(i-1), 2^i) us. the last
+// bucket also takes everything longer.
+struct Histogram {
+    static constexpr size_t BUCKETS = 32;
+
+    std::array<uint64_t, BUCKETS> buckets{};
+    uint64_t count = 0;
+    uint64_t total_us = 0;
+
+    static size_t bucket_of(uint64_t us);
+    // exclusive upper bound of bucket `i`, in us
+    static uint64_t bucket_limit(size_t i) { return uint64_t{1} << i; }
+
+    double mean_us() const;
+    // upper bound of the bucket holding the p-th percentile, 0 < p <= 100
+    uint64_t percentile_us(double p) const;
+};
+
+// snapshot of the counters of one BufferManager. taken while the pool is
+// running, so the counters can be a few events apart from each other.
+struct BufferPoolStats {
+    size_t frames = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;       // pages unmapped to reuse their frame, ring recycling included
+    uint64_t dirty_evictions = 0; // of those, pages written back on the spot
+    uint64_t reads = 0;           // pages read from disk, prefetches included
+    uint64_t prefetches = 0;      // pages read by prefetch()
+    uint64_t writes = 0;          // pages written to disk
+    uint64_t new_pages = 0;       // pages created by new_page(), which reads nothing
+    Histogram miss_latency;       // request() misses: getting a frame and reading the page
+    Histogram latch_wait;         // read_page()/write_page() calls that found the frame latched
+
+    double hit_ratio() const;
+    std::string to_string() const;
+};
+
+// lock-free histogram behind BufferPoolStats; updates are relaxed
+class AtomicHistogram {
+public:
+    void record(std::chrono::nanoseconds latency);
+    void snapshot(Histogram& out) const;
+
+private:
+    std::array<std::atomic<uint64_t>, Histogram::BUCKETS> buckets_{};
+    std::atomic<uint64_t> count_ = 0;
+    std::atomic<uint64_t> total_us_ = 0;
+};
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "storage/disk_manager/disk_manager.h"
+
+namespace db::storage {
+enum class TraceOp : uint8_t { REQUEST = 0, RELEASE = 1 };
+
+// one request() or release(). on disk a record is packed into
+// TRACE_RECORD_SIZE bytes in native byte order: page id, op, then the time in
+// microseconds since the trace was started.
+struct TraceRecord {
+    page_id_t page_id;
+    TraceOp op;
+    uint64_t micros;
+};
+
+inline constexpr char TRACE_MAGIC[8] = {'B', 'P', 'T', 'R', 'A', 'C', 'E', '1'};
+inline constexpr size_t TRACE_RECORD_SIZE = sizeof(page_id_t) + 1 + sizeof(uint64_t);
+
+// appends records of the buffer pool's page accesses to a trace file.
+// thread-safe; records are buffered and written in batches of
+// TRACE_BUFFER_RECORDS, so a trace is only complete after stop().
+class BufferTrace {
+public:
+    BufferTrace() = default;
+    BufferTrace(const BufferTrace& other) = delete;
+    BufferTrace& operator=(const BufferTrace& other) = delete;
+    ~BufferTrace();
+
+    // truncates `path`. throws std::runtime_error if it cannot be opened
+    // or a trace is running already.
+    void start(const std::string& path);
+    void stop();
+
+    bool active() const { return active_.load(std::memory_order_relaxed); }
+    void record(page_id_t pid, TraceOp op);
+
+private:
+    void write_buffer(); // mu_ held
+
+    std::mutex mu_;
+    std::ofstream out_;
+    std::vector<char> buffer_;
+    std::chrono::steady_clock::time_point started_;
+    std::atomic<bool> active_ = false;
+};
+
+// reads a trace written by BufferTrace record by record
+class TraceReader {
+public:
+    // throws std::runtime_error if `path` cannot be opened or is no trace
+    explicit TraceReader(const std::string& path);
+
+    // false at the end of the trace. a record cut short, e.g. because the
+    // process died before stop(), also ends it.
+    bool next(TraceRecord& out);
+
+private:
+    std::ifstream in_;
+};
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include "storage/disk_manager/idisk_manager.h"
+
+namespace db::storage {
+// IDiskManager of a buffer pool shared by several databases. page ids in
+// the pool carry the database's slot in their high bits:
+// (slot << DATABASE_PAGE_BITS) | page id. every call is routed to the
+// slot's disk manager with the database's own page id.
+//
+// pages are allocated through the database's disk manager, not here.
+class DatabaseDisks : public IDiskManager {
+public:
+    // pages addressable per database: 2^24 pages = 128 GB
+    static constexpr int DATABASE_PAGE_BITS = 24;
+    static constexpr uint32_t MAX_DATABASES = 1u << (31 - DATABASE_PAGE_BITS);
+
+    // per-database counters, updated by the pool with relaxed atomics
+    struct Slot {
+        std::atomic<IDiskManager*> disk = nullptr;
+        std::atomic<uint64_t> resident = 0; // frames holding pages of the database
+        std::atomic<uint64_t> hits = 0;
+        std::atomic<uint64_t> misses = 0;
+        std::atomic<uint64_t> evictions = 0;
+        std::atomic<uint64_t> dirty_evictions = 0;
+        std::atomic<uint64_t> reads = 0;
+        std::atomic<uint64_t> prefetches = 0;
+        std::atomic<uint64_t> writes = 0;
+        std::atomic<uint64_t> new_pages = 0;
+    };
+
+    DatabaseDisks();
+
+    // takes the lowest free slot. throws std::runtime_error if all
+    // MAX_DATABASES are taken.
+    uint32_t attach(IDiskManager* dm);
+    // the slot's pages must no longer be cached
+    void detach(uint32_t slot);
+    size_t attached() const { return attached_.load(std::memory_order_relaxed); }
+    Slot& slot(uint32_t slot) { return slots_[slot]; }
+    const Slot& slot(uint32_t slot) const { return slots_[slot]; }
+
+    static uint32_t DatabaseOf(page_id_t pid) {
+        return static_cast<uint32_t>(pid) >> DATABASE_PAGE_BITS;
+    }
+    static page_id_t PageOf(page_id_t pid) {
+        return static_cast<page_id_t>(static_cast<uint32_t>(pid) & ((1u << DATABASE_PAGE_BITS) - 1));
+    }
+    static page_id_t PoolPageId(uint32_t slot, page_id_t pid) {
+        return static_cast<page_id_t>((slot << DATABASE_PAGE_BITS) | static_cast<uint32_t>(pid));
+    }
+
+    void ReadPage(page_id_t page_id, char* page_data) override;
+    void WritePage(page_id_t page_id, const char* page_data) override;
+    void ReadPages(std::span<const page_id_t> page_ids,
+                   std::span<char* const> pages) override;
+    void WritePages(std::span<const page_id_t> page_ids,
+                    std::span<const char* const> pages) override;
+    void ReadPageAsync(page_id_t page_id, char* page_data, IOCallback on_complete) override;
+    void WritePageAsync(page_id_t page_id, const char* page_data, IOCallback on_complete) override;
+
+    // throw std::logic_error: the pool cannot tell which database a new
+    // page belongs to
+    page_id_t AllocatePage() override;
+    page_id_t AllocateFilePage(const config::uuid_t& file_id) override;
+    void DeallocatePage(page_id_t page_id) override;
+
+    // syncs every attached database
+    void Sync() override;
+
+private:
+    // throws std::runtime_error if no database is attached to the slot
+    IDiskManager* disk_of(page_id_t pid);
+
+    std::mutex mu_; // attach and detach
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<size_t> attached_ = 0;
+};
+}
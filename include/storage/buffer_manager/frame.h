@@ -1,12 +1,51 @@
 #pragma once
+#include <atomic>
+#include <shared_mutex>
 #include "storage/disk_manager/disk_manager.h"
 #define INVALID_PAGE_ID -1
 
 namespace db::storage {
 struct Frame {
-    page_id_t page_id = INVALID_PAGE_ID;
-    int pin_count = 0;
-    uint8_t dirty = 0; // 0 = not dirty, 1 = dirty
-    char* data; // memory region for page content
+    // page_id changes only under the page table shard latch of the page,
+    // but is read without it by the eviction path
+    std::atomic<page_id_t> page_id = INVALID_PAGE_ID;
+    std::atomic<int> pin_count = 0;
+    std::atomic<uint8_t> dirty = 0; // 0 = not dirty, 1 = dirty
+    char* data = nullptr; // memory region for page content
+
+    // protects `data` while the page is pinned; held through
+    // ReadPageGuard (shared) and WritePageGuard (exclusive)
+    std::shared_mutex latch;
+
+    // seqlock for optimistic readers: odd while a WritePageGuard writes
+    // the page, and advanced whenever the frame is handed to another page
+    std::atomic<uint64_t> version = 0;
+
+    Frame() = default;
+
+    // copyable so frames can live in a std::vector. copying a frame
+    // that other threads are using is not meaningful, and the latch and
+    // version are not copied.
+    Frame(const Frame& other)
+        : page_id{other.page_id.load()},
+          pin_count{other.pin_count.load()},
+          dirty{other.dirty.load()},
+          data{other.data} {}
+
+    Frame& operator=(const Frame& other) {
+        page_id = other.page_id.load();
+        pin_count = other.pin_count.load();
+        dirty = other.dirty.load();
+        data = other.data;
+        return *this;
+    }
+
+    // the fence keeps the page changes that follow from becoming visible
+    // before the odd version
+    void begin_write() {
+        version.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+    void end_write() { version.fetch_add(1, std::memory_order_release); }
 };
-}
\ No newline at end of file
+}
@@ -1,8 +1,10 @@
 #pragma once
+#include <mutex>
 #include <vector>
 #include "storage/buffer_manager/frame.h"
 
 namespace db::storage {
+// thread-safe: all operations take an internal latch
 class FreeList {
 public:
     FreeList();
@@ -21,6 +23,7 @@ public:
     bool empty() const noexcept;
 
 private:
+    mutable std::mutex mu_;
     std::vector<Frame*> list_;
 };
 }
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+#include "storage/buffer_manager/frame.h"
+
+namespace db::storage {
+class BufferManager;
+
+// a pinned page whose frame latch is held. the latch and the pin are
+// dropped together when the guard is destroyed, released or moved onto.
+// obtained from BufferManager::read_page() and write_page().
+class PageGuard {
+public:
+    PageGuard(const PageGuard& other) = delete;
+    PageGuard& operator=(const PageGuard& other) = delete;
+
+    page_id_t page_id() const { return pid_; }
+    bool valid() const { return frame_ != nullptr; }
+
+protected:
+    PageGuard() = default;
+    PageGuard(BufferManager* bm, Frame* frame, page_id_t pid)
+        : bm_{bm}, frame_{frame}, pid_{pid} {}
+    PageGuard(PageGuard&& other) noexcept;
+    ~PageGuard() = default;
+
+    void take(PageGuard& other) noexcept;
+    void drop(bool exclusive);
+
+    BufferManager* bm_ = nullptr;
+    Frame* frame_ = nullptr;
+    page_id_t pid_ = INVALID_PAGE_ID;
+};
+
+// shared latch: any number of readers of a page proceed in parallel
+class ReadPageGuard : public PageGuard {
+public:
+    ReadPageGuard() = default;
+    ReadPageGuard(ReadPageGuard&& other) noexcept = default;
+    ReadPageGuard& operator=(ReadPageGuard&& other) noexcept;
+    ~ReadPageGuard() { release(); }
+
+    const char* data() const { return frame_->data; }
+    void release() { drop(false); }
+
+private:
+    friend class BufferManager;
+    using PageGuard::PageGuard;
+};
+
+// exclusive latch: waits for readers and other writers of the page
+class WritePageGuard : public PageGuard {
+public:
+    WritePageGuard() = default;
+    WritePageGuard(WritePageGuard&& other) noexcept = default;
+    WritePageGuard& operator=(WritePageGuard&& other) noexcept;
+    ~WritePageGuard() { release(); }
+
+    char* data() const { return frame_->data; }
+    void mark_dirty();
+    void release() { drop(true); }
+
+private:
+    friend class BufferManager;
+    using PageGuard::PageGuard;
+};
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include "storage/buffer_manager/replacement_policies/replacement.h"
+#include "config/config.h"
+
+namespace db::storage {
+// ARC (Megiddo, Modha). resident pages are split into T1 (seen once
+// recently) and T2 (seen at least twice), both LRU. pages evicted from
+// them are remembered by id in the ghost lists B1 and B2. a load that hits
+// B1 means T1 was too small and grows the target size p of T1; a load that
+// hits B2 shrinks it. victims come from T1 while it is larger than p,
+// otherwise from T2, so the split follows the workload: scans keep
+// landing in T1, and lookup traffic grows T2.
+//
+// a hit in T1 within `correlated_period` ticks of the page's previous
+// reference does not promote it, so the per-tuple requests of one scan
+// count as a single reference.
+//
+// all state is guarded by one internal latch.
+class ARCPolicy : public IReplacementPolicy {
+public:
+    explicit ARCPolicy(std::vector<Frame*>& frames,
+                       uint64_t correlated_period = config::CORRELATED_REFERENCE_PERIOD);
+
+    void record_access(Frame* f) override;
+    void record_load(Frame* f) override;
+    void record_unpin(Frame* f) override;
+
+    Frame* choose_victim() override;
+    void upcoming_victims(size_t n, std::vector<Frame*>& out) override;
+    bool referenced(Frame* f) override;
+
+    // current target size of T1, between 0 and the pool size
+    size_t target() const;
+
+private:
+    enum class Queue : uint8_t { NONE, T1, T2, B1, B2 };
+
+    struct Slot {
+        page_id_t page_id = INVALID_PAGE_ID;
+        Queue queue = Queue::NONE;
+        std::list<size_t>::iterator pos;
+        uint64_t last = 0; // most recent reference
+    };
+
+    struct Ghost {
+        Queue queue;
+        std::list<page_id_t>::iterator pos;
+    };
+
+    void load(size_t idx, page_id_t pid);
+    void touch(size_t idx);
+    void forget(size_t idx);
+    void add_ghost(Queue queue, page_id_t pid);
+    void drop_ghost_lru(Queue queue);
+    Frame* lru_unpinned(const std::list<size_t>& queue) const;
+
+    mutable std::mutex mu_;
+    size_t c_;
+    size_t p_ = 0;
+    uint64_t now_ = 0;
+    uint64_t correlated_period_;
+
+    std::vector<Slot> slots_;
+    std::set<size_t> untracked_; // slots never loaded: nothing to lose
+    std::list<size_t> t1_; // front = most recently used
+    std::list<size_t> t2_;
+    std::list<page_id_t> b1_;
+    std::list<page_id_t> b2_;
+    std::unordered_map<page_id_t, Ghost> ghosts_;
+    std::unordered_map<page_id_t, size_t> resident_; // page -> slot
+    std::unordered_map<Frame*, size_t> frame_idx_;
+    std::vector<Frame*>& frames_;
+};
+}
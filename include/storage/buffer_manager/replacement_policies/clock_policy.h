@@ -1,7 +1,15 @@
 #pragma once
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 #include "storage/buffer_manager/replacement_policies/replacement.h"
 
 namespace db::storage {
+// lock-free CLOCK: reference bits and the hand are atomics, and the
+// frame -> index map is read-only after construction. concurrent callers
+// of choose_victim may be handed the same frame; the buffer manager
+// settles that when it claims the frame.
 class ClockPolicy : public IReplacementPolicy {
 public:
     explicit ClockPolicy(std::vector<Frame*>& frames);
@@ -12,11 +20,13 @@ public:
     void advance_hand();
 
     Frame* choose_victim() override;
+    void upcoming_victims(size_t n, std::vector<Frame*>& out) override;
+    bool referenced(Frame* f) override;
 
 private:
-    size_t hand_;
+    std::atomic<size_t> hand_;
     size_t N_;
-    std::vector<int> ref_bits_;
+    std::unique_ptr<std::atomic<uint8_t>[]> ref_bits_;
     std::unordered_map<Frame*, size_t> frame_idx_;
     std::vector<Frame*>& frames_;
 };
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+#include "storage/buffer_manager/replacement_policies/replacement.h"
+#include "config/config.h"
+
+namespace db::storage {
+// LRU-K (O'Neil, O'Neil, Weikum): evicts the unpinned page whose K-th most
+// recent reference is oldest. pages referenced fewer than K times have an
+// infinite backward distance and go first, so a sequential scan cannot push
+// out pages that are referenced repeatedly.
+//
+// a reference within `correlated_period` ticks (one tick per hit or load)
+// of the page's previous one is correlated and does not count again. the
+// heap iterator requests a page once per tuple, so without this a single
+// scan would look like K references. histories of up to `retained_pages`
+// evicted pages are kept so a page that comes back is not treated as new.
+//
+// resident pages are kept ordered by their K-th reference, so finding a
+// victim only skips pinned pages and the few inside their correlated
+// period instead of scanning the pool. all state is guarded by one
+// internal latch.
+class LRUKPolicy : public IReplacementPolicy {
+public:
+    explicit LRUKPolicy(std::vector<Frame*>& frames);
+    LRUKPolicy(std::vector<Frame*>& frames, size_t k,
+               uint64_t correlated_period, size_t retained_pages);
+
+    void record_access(Frame* f) override;
+    void record_load(Frame* f) override;
+    void record_unpin(Frame* f) override;
+
+    Frame* choose_victim() override;
+    void upcoming_victims(size_t n, std::vector<Frame*>& out) override;
+    bool referenced(Frame* f) override;
+
+private:
+    struct History {
+        std::vector<uint64_t> hist; // hist[i]: (i+1)-th most recent reference, 0 = none
+        uint64_t last = 0;          // most recent reference, correlated or not
+    };
+
+    struct Slot {
+        page_id_t page_id = INVALID_PAGE_ID;
+        History history;
+    };
+
+    struct Retained {
+        History history;
+        uint64_t evicted_at;
+    };
+
+    // eviction order without the correlated period: the K-th most recent
+    // reference (0 = fewer than K, i.e. infinitely old), then the most
+    // recent one, then the slot
+    using Key = std::tuple<uint64_t, uint64_t, size_t>;
+
+    Key victim_key(size_t idx) const;
+    bool correlated(size_t idx) const;
+    void reference(size_t idx);
+    void load(size_t idx, page_id_t pid);
+    void retain(page_id_t pid, History h);
+
+    std::mutex mu_;
+    uint64_t now_ = 0;
+    size_t k_;
+    uint64_t correlated_period_;
+    size_t retained_pages_;
+
+    std::vector<Slot> slots_;
+    std::set<Key> order_; // slots holding a page
+    std::set<size_t> untracked_; // slots without one: nothing to lose
+    std::unordered_map<Frame*, size_t> frame_idx_;
+    std::unordered_map<page_id_t, size_t> resident_; // page -> slot
+    std::unordered_map<page_id_t, Retained> retained_;
+    std::deque<std::pair<page_id_t, uint64_t>> retained_order_; // oldest first
+    std::vector<Frame*>& frames_;
+};
+}
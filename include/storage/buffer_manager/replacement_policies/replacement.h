@@ -1,4 +1,5 @@
 #pragma once
+#include <vector>
 #include "storage/buffer_manager/frame.h"
 
 namespace db::storage {
@@ -10,5 +11,15 @@ public:
     virtual void record_load(Frame* f) = 0; // page loaded into a frame
     virtual void record_unpin(Frame* f) = 0; // unpinned, may become candidate
     virtual Frame* choose_victim() = 0;
+
+    // appends up to `n` unpinned frames holding a page, in the order the policy would
+    // evict them, without changing any state. used by the background
+    // writer to clean pages before they are chosen.
+    virtual void upcoming_victims(size_t n, std::vector<Frame*>& out) = 0;
+
+    // whether the policy has seen the frame's page referenced again since
+    // it was loaded: the CLOCK reference bit, K references for LRU-K, Am
+    // for 2Q and T2 for ARC. saved with the warm set.
+    virtual bool referenced(Frame* f) = 0;
 };
 }
\ No newline at end of file
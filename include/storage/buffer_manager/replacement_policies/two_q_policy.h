@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include "storage/buffer_manager/replacement_policies/replacement.h"
+#include "config/config.h"
+
+namespace db::storage {
+// full 2Q (Johnson, Shasha). pages loaded for the first time enter A1in, a
+// FIFO of at most `kin` frames; hits there are treated as correlated and
+// ignored. pages evicted from A1in are remembered by id in the ghost FIFO
+// A1out (at most `kout` ids). a page that is loaded again while in A1out
+// goes to Am, an LRU list of the pages that proved to be hot. a scan
+// therefore only cycles through A1in and leaves Am alone.
+//
+// all state is guarded by one internal latch.
+class TwoQPolicy : public IReplacementPolicy {
+public:
+    explicit TwoQPolicy(std::vector<Frame*>& frames);
+    TwoQPolicy(std::vector<Frame*>& frames, size_t kin, size_t kout);
+
+    void record_access(Frame* f) override;
+    void record_load(Frame* f) override;
+    void record_unpin(Frame* f) override;
+
+    Frame* choose_victim() override;
+    void upcoming_victims(size_t n, std::vector<Frame*>& out) override;
+    bool referenced(Frame* f) override;
+
+private:
+    enum class Queue : uint8_t { NONE, A1IN, AM };
+
+    struct Slot {
+        page_id_t page_id = INVALID_PAGE_ID;
+        Queue queue = Queue::NONE;
+        std::list<size_t>::iterator pos;
+    };
+
+    void load(size_t idx, page_id_t pid);
+    void touch(size_t idx);
+    Frame* oldest_unpinned(const std::list<size_t>& queue) const;
+
+    std::mutex mu_;
+    size_t kin_;
+    size_t kout_;
+
+    std::vector<Slot> slots_;
+    std::set<size_t> untracked_; // slots never loaded: nothing to lose
+    std::list<size_t> a1in_; // front = newest
+    std::list<size_t> am_;   // front = most recently used
+    std::list<page_id_t> a1out_; // front = most recently evicted
+    std::unordered_map<page_id_t, std::list<page_id_t>::iterator> a1out_idx_;
+    std::unordered_map<page_id_t, size_t> resident_; // page -> slot
+    std::unordered_map<Frame*, size_t> frame_idx_;
+    std::vector<Frame*>& frames_;
+};
+}
@@ -1,18 +1,77 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
-#include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <vector> 
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 #include "storage/disk_manager/idisk_manager.h"
+#include "config/config.h"
+#include "util/uuid.h"
 
 namespace db::storage {
 struct DBHeaderPage {
     uint32_t magic; // magic number to indicate db is initialised
 };
+
+// header of an on-disk allocation map page. the rest of the page is a
+// bitmap with one bit per logical page (1 = allocated).
+//
+// maps are interleaved with data pages: map k is stored at physical page
+// k * (PAGES_PER_ALLOC_MAP + 1), directly before the pages it covers.
+// page ids handed out by the DiskManager are logical and never see them.
+struct AllocMapHeader {
+    uint32_t magic;
+    uint32_t version; // config::DISK_FORMAT_VERSION of the file
+};
+inline constexpr size_t PAGES_PER_ALLOC_MAP =
+    (config::PAGE_SIZE - sizeof(AllocMapHeader)) * 8;
+
+// header of a page written in compress mode. the compressed bytes follow
+// it; the rest of the page slot is a hole in the file.
+struct CompressedPageHeader {
+    uint32_t magic;
+    uint16_t length;   // compressed bytes after the header
+    uint16_t reserved;
+    uint32_t checksum; // crc32c of the compressed bytes
+};
+
+struct DiskManagerOptions {
+    // bypass the OS page cache (O_DIRECT on linux, F_NOCACHE on macOS).
+    // the buffer pool is then the only cache between the engine and disk.
+    bool direct_io = false;
+
+    // serve reads from a shared read-only mapping of the file instead of
+    // pread. writes still go through pwrite, which the mapping observes.
+    // intended for read-mostly databases; cannot be combined with direct_io.
+    bool use_mmap = false;
+
+    // virtual address space mapped up front. growing past it maps a new,
+    // larger region; earlier regions stay mapped until destruction so
+    // pointers from PageData() remain valid.
+    size_t mmap_reserve = config::MMAP_RESERVE_SIZE;
+
+    // store pages LZ-compressed. a page keeps its fixed slot in the file,
+    // but only the blocks holding compressed data are written and the rest
+    // of the slot is punched out, so sparse pages take less disk space and
+    // read bandwidth. pages that do not shrink by a block are stored as is.
+    // cannot be combined with use_mmap.
+    bool compress = false;
+};
+
+// page I/O may be issued from several threads at once. allocation and
+// the mmap bookkeeping are serialised by internal latches.
 class DiskManager : public IDiskManager {
 public:
-    explicit DiskManager(const std::string &db_file);
+    explicit DiskManager(const std::string &db_file,
+                         DiskManagerOptions options = {});
     DiskManager(const DiskManager& other) = delete;
     DiskManager& operator=(const DiskManager& other) = delete;
     DiskManager(DiskManager&& other) = delete;
@@ -22,14 +81,140 @@ public:
 
     void ReadPage(page_id_t page_id, char* page_data) override;
     void WritePage(page_id_t page_id, const char* page_data) override;
+    void ReadPages(std::span<const page_id_t> page_ids,
+                   std::span<char* const> pages) override;
+    void WritePages(std::span<const page_id_t> page_ids,
+                    std::span<const char* const> pages) override;
     page_id_t AllocatePage() override;
     void DeallocatePage(page_id_t page_id) override;
+    void Sync() override;
+
+    // asynchronous reads are queued for one I/O thread, started by the
+    // first of them. it issues everything queued meanwhile as one
+    // ReadPages batch, so a readahead of adjacent pages becomes vectored
+    // reads. the callback runs on that thread.
+    std::future<void> ReadPageAsync(page_id_t page_id, char* page_data) override;
+    void ReadPageAsync(page_id_t page_id, char* page_data, IOCallback on_complete) override;
+
+    // hands out the next page of the file's current extent. when it is used
+    // up, a new contiguous extent (EXTENT_MIN_PAGES, doubling up to
+    // EXTENT_MAX_PAGES) is taken from a run of freed pages, or else
+    // reserved and preallocated at the end of the database file, so a
+    // table's pages stay physically sequential and freed space is reused.
+    page_id_t AllocateFilePage(const config::uuid_t& file_id) override;
 
+    // number of logical pages stored in the file (allocation maps excluded)
     int GetNumPages() const;
 
+    // zero-copy access to a page in use_mmap mode. returns nullptr for
+    // pages past the end of the file. valid for the DiskManager's lifetime.
+    const char* PageData(page_id_t page_id);
+
 private:
-    mutable std::fstream db_io_;
+    // logical page id -> physical page index in the file
+    static size_t PhysicalPage(page_id_t page_id);
+
+    // rewrites a database file of format version 1 (a flat array of
+    // pages, no allocation maps) into the current layout. other files
+    // are left untouched.
+    static void MigrateFlatFile(const std::string& db_file);
+
+    // physical page I/O. handles the direct I/O bounce page.
+    void ReadPhysical(size_t phys, char* buf);
+    void WritePhysical(size_t phys, const char* buf);
+
+    // compress mode page I/O
+    void ReadCompressed(size_t phys, char* buf);
+    void WriteCompressed(size_t phys, const char* buf);
+
+    // allocation map helpers
+    void LoadAllocMaps();
+    void SetAllocated(page_id_t page_id, bool allocated);
+    bool IsAllocated(page_id_t page_id) const;
+    void WriteDirtyAllocMaps();
+    // makes the map bits of pages allocated since the last sync durable
+    // before any of `page_ids` is written
+    void PersistAllocations(std::span<const page_id_t> page_ids);
+    void SyncFile();
+
+    // raises phys_pages_ to at least n
+    void GrowPhysPages(size_t n);
+
+    // takes a run of consecutive free pages off the free list: the first
+    // run of at least n pages (n of them), else the longest run of at
+    // least EXTENT_MIN_PAGES. returns {start, length}; length 0 if none.
+    std::pair<page_id_t, size_t> ReuseFreeRun(size_t n);
+
+    // reserves [start, start + n) at the end of the file
+    page_id_t ReserveExtent(size_t n);
+
+    // positional I/O helpers. both loop until `len` bytes are transferred
+    // and throw on error. ReadAt zero-fills anything past end of file.
+    void ReadAt(size_t offset, char* buf, size_t len);
+    void WriteAt(size_t offset, const char* buf, size_t len);
+
+    // sorts the batch by page id and issues one preadv/pwritev per run of
+    // adjacent ids. pages[i] is a char* (read) or const char* (write).
+    void TransferPages(bool write, std::span<const page_id_t> page_ids,
+                       const char* const* pages);
+
+    // mmap mode helpers. callers hold map_mu_.
+    const char* MappedPage(page_id_t page_id);
+    void MapFile(size_t min_len);
+    void AdviseAccess(page_id_t page_id);
+
+    // asynchronous reads
+    struct PendingRead {
+        page_id_t page_id;
+        char* data;
+        IOCallback on_complete;
+    };
+    void ReadLoop();
+
+    int fd_;
+    DiskManagerOptions options_;
+
+    // reads waiting for the I/O thread, guarded by read_mu_
+    std::mutex read_mu_;
+    std::condition_variable read_cv_;
+    std::vector<PendingRead> pending_reads_;
+    bool stopping_ = false;
+    std::thread reader_;
+
+    // mmap mode state, guarded by map_mu_
+    std::mutex map_mu_;
+    char* map_ = nullptr;
+    size_t map_len_ = 0;
+    std::vector<std::pair<char*, size_t>> retired_maps_;
+    page_id_t last_read_ = -1;
+    size_t seq_run_ = 0;
+    size_t random_run_ = 0;
+    page_id_t readahead_end_ = 0;
+    int advice_ = 0;
+
+    std::atomic<size_t> phys_pages_ = 0; // physical pages backed by the file
+
+    // allocation state, guarded by alloc_mu_. the maps are the persistent
+    // truth; free_list is rebuilt from them on open and gives O(1)
+    // allocate/free.
+    std::mutex alloc_mu_;
+    std::vector<std::unique_ptr<char[]>> alloc_maps_;
+    std::vector<bool> alloc_map_dirty_;
     std::vector<page_id_t> free_list;
     page_id_t next_page_id_;
+    // allocated, but the map bit is not durable yet. a write of one of
+    // these pages persists the maps first; the count skips the latch.
+    std::unordered_set<page_id_t> unsynced_allocs_;
+    std::atomic<size_t> unsynced_count_ = 0;
+
+    // extent currently being filled by each file. reserved pages are only
+    // marked allocated when handed out, so an unused tail is reclaimed on
+    // restart instead of leaking.
+    struct Extent {
+        page_id_t next;
+        page_id_t end;
+        size_t size;
+    };
+    std::unordered_map<config::uuid_t, Extent, util::UUIDHash> extents_;
 };
 }
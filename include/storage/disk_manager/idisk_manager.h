@@ -1,6 +1,11 @@
 #pragma once
 
 #include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <span>
+#include "config/config.h"
 
 namespace db::storage {
 
@@ -8,12 +13,92 @@ using page_id_t = int32_t;
 
 class IDiskManager {
 public:
+    using IOCallback = std::function<void(std::exception_ptr)>;
+
     virtual ~IDiskManager() = default;
 
     virtual void ReadPage(page_id_t page_id, char* page_data) = 0;
     virtual void WritePage(page_id_t page_id, const char* page_data) = 0;
     virtual page_id_t AllocatePage() = 0;
     virtual void DeallocatePage(page_id_t page_id) = 0;
+
+    // allocates a page on behalf of a file (e.g. a heap file id).
+    // implementations may hand out pages from a contiguous extent
+    // reserved for that file; the default ignores the owner.
+    virtual page_id_t AllocateFilePage(const config::uuid_t& /*file_id*/) {
+        return AllocatePage();
+    }
+
+    // makes every completed WritePage durable.
+    // writes are not flushed individually; callers sync at checkpoints.
+    virtual void Sync() = 0;
+
+    // batched page I/O: page_ids[i] is transferred to/from pages[i].
+    // ids need not be sorted or contiguous; implementations may merge
+    // runs of adjacent ids into a single vectored I/O.
+    // the defaults issue one single-page call per id.
+    virtual void ReadPages(std::span<const page_id_t> page_ids,
+                           std::span<char* const> pages) {
+        for (size_t i = 0; i < page_ids.size(); ++i) {
+            ReadPage(page_ids[i], pages[i]);
+        }
+    }
+
+    virtual void WritePages(std::span<const page_id_t> page_ids,
+                            std::span<const char* const> pages) {
+        for (size_t i = 0; i < page_ids.size(); ++i) {
+            WritePage(page_ids[i], pages[i]);
+        }
+    }
+
+    // asynchronous page I/O. the buffer must stay valid until the future
+    // is ready. the default runs the synchronous call and returns a ready
+    // future, so callers can always use this API.
+    virtual std::future<void> ReadPageAsync(page_id_t page_id, char* page_data) {
+        std::promise<void> done;
+        try {
+            ReadPage(page_id, page_data);
+            done.set_value();
+        } catch (...) {
+            done.set_exception(std::current_exception());
+        }
+        return done.get_future();
+    }
+
+    virtual std::future<void> WritePageAsync(page_id_t page_id, const char* page_data) {
+        std::promise<void> done;
+        try {
+            WritePage(page_id, page_data);
+            done.set_value();
+        } catch (...) {
+            done.set_exception(std::current_exception());
+        }
+        return done.get_future();
+    }
+
+    // completion-callback flavour. the callback receives nullptr on
+    // success. the defaults run the synchronous call and invoke the
+    // callback before returning; implementations with I/O workers call
+    // it from a worker.
+    virtual void ReadPageAsync(page_id_t page_id, char* page_data, IOCallback on_complete) {
+        std::exception_ptr err;
+        try {
+            ReadPage(page_id, page_data);
+        } catch (...) {
+            err = std::current_exception();
+        }
+        on_complete(err);
+    }
+
+    virtual void WritePageAsync(page_id_t page_id, const char* page_data, IOCallback on_complete) {
+        std::exception_ptr err;
+        try {
+            WritePage(page_id, page_data);
+        } catch (...) {
+            err = std::current_exception();
+        }
+        on_complete(err);
+    }
 };
 
 }
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+
+namespace db::storage {
+
+// small LZ77 codec in the style of LZ4, tuned for 8 KB pages.
+// a block is a series of sequences:
+//   token (literal length << 4 | match length - 4), literals,
+//   2 byte little-endian match offset, optional length bytes.
+// a length nibble of 15 continues in following bytes (255 = keep going).
+// the last sequence has literals only.
+
+// compresses `len` bytes into `dst`. returns the compressed size, or 0
+// if the output does not fit in `capacity` bytes.
+size_t LZCompress(const char* src, size_t len, char* dst, size_t capacity);
+
+// decompresses into exactly `dst_len` bytes. returns false if the input
+// is malformed or does not decode to that size.
+bool LZDecompress(const char* src, size_t len, char* dst, size_t dst_len);
+
+}
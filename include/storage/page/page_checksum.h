@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "config/config.h"
+
+namespace db::storage {
+
+// every page ends in a 4 byte CRC32C of the bytes before it.
+// page layouts must stay within the first PAGE_DATA_SIZE bytes.
+inline constexpr size_t PAGE_CHECKSUM_OFFSET = config::PAGE_DATA_SIZE;
+
+// CRC32C (Castagnoli) of `len` bytes, continuing from `crc`.
+// uses the SSE4.2 crc32 instruction when the cpu has it,
+// slicing-by-8 tables otherwise.
+uint32_t Crc32c(const void* data, size_t len, uint32_t crc = 0);
+
+// true if Crc32c runs on the hardware instruction
+bool Crc32cHardwareAccelerated();
+
+uint32_t ComputePageChecksum(const char* page);
+uint32_t GetPageChecksum(const char* page);
+
+// computes the checksum and stores it in the page trailer
+void SetPageChecksum(char* page);
+
+// true if the stored checksum matches the contents. a page that was
+// never written (all zeroes) also verifies.
+bool VerifyPageChecksum(const char* page);
+
+}
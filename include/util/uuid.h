@@ -2,6 +2,7 @@
 #include <array>
 #include <random>
 #include <cstdint>
+#include <cstddef>
 #include "config/config.h"
 
 namespace util {
@@ -31,4 +32,16 @@ constexpr db::config::uuid_t MakeUUID(
              b8, b9, b10, b11, b12, b13, b14, b15 }};
 }
 
+// hasher so uuids can key unordered containers (FNV-1a)
+struct UUIDHash {
+    size_t operator()(const db::config::uuid_t& uuid) const noexcept {
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (uint8_t b : uuid) {
+            h ^= b;
+            h *= 0x100000001b3ull;
+        }
+        return static_cast<size_t>(h);
+    }
+};
+
 }
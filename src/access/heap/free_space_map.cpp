@@ -0,0 +1,173 @@
+#include "access/heap/free_space_map.h"
+#include <algorithm>
+#include <cstring>
+
+namespace db::access {
+namespace {
+// the entries and the max-tree of an FSM page
+struct FsmPage {
+    explicit FsmPage(char* data)
+        : hdr{reinterpret_cast<FsmPageHeader*>(data)},
+          ids{reinterpret_cast<page_id_t*>(data + sizeof(FsmPageHeader))},
+          tree{reinterpret_cast<uint8_t*>(data + sizeof(FsmPageHeader)
+                                          + FSM_SLOTS * sizeof(page_id_t))} {}
+
+    static void Init(char* data) {
+        std::memset(data, 0, config::PAGE_DATA_SIZE);
+        reinterpret_cast<FsmPageHeader*>(data)->magic = FSM_MAGIC;
+        reinterpret_cast<FsmPageHeader*>(data)->last_page_id = INVALID_PAGE_ID;
+    }
+
+    uint8_t Max() const { return tree[1]; }
+
+    // the leftmost entry of at least category `cat`
+    std::optional<uint32_t> Find(uint8_t cat) const {
+        if (hdr->count == 0 || tree[1] < cat) return std::nullopt;
+        uint32_t node = 1;
+        while (node < FSM_SLOTS) {
+            node = tree[2 * node] >= cat ? 2 * node : 2 * node + 1;
+        }
+        return node - FSM_SLOTS;
+    }
+
+    // the maximum of the page if entry i had category `cat`
+    uint8_t MaxWith(uint32_t i, uint8_t cat) const {
+        uint8_t max = cat;
+        for (uint32_t node = FSM_SLOTS + i; node > 1; node /= 2) {
+            max = std::max(max, tree[node ^ 1]);
+        }
+        return max;
+    }
+
+    // returns whether the maximum of the page changed
+    bool Set(uint32_t i, uint8_t cat) {
+        uint8_t old_max = tree[1];
+        uint32_t node = FSM_SLOTS + i;
+        tree[node] = cat;
+        for (node /= 2; node >= 1; node /= 2) {
+            tree[node] = std::max(tree[2 * node], tree[2 * node + 1]);
+        }
+        return tree[1] != old_max;
+    }
+
+    FsmPageHeader* hdr;
+    page_id_t* ids;
+    uint8_t* tree;
+};
+
+uint8_t Category(size_t free) {
+    return static_cast<uint8_t>(std::min<size_t>(255, free / FSM_CATEGORY_BYTES));
+}
+
+// the lowest category that guarantees `len` bytes; 256 if none does
+size_t NeededCategory(size_t len) {
+    return (len + FSM_CATEGORY_BYTES - 1) / FSM_CATEGORY_BYTES;
+}
+}
+
+FreeSpaceMap::FreeSpaceMap(storage::BufferManager* bm, const config::uuid_t& file_id,
+                           page_id_t root_page_id)
+    : _bm{bm}, _file_id{file_id}, _root_page_id{root_page_id} {}
+
+page_id_t FreeSpaceMap::Build(storage::BufferManager* bm, const config::uuid_t& file_id,
+                              const std::vector<std::pair<page_id_t, size_t>>& pages) {
+    auto root = bm->new_page(file_id);
+    FsmPage::Init(root.data());
+    FreeSpaceMap fsm{bm, file_id, root.page_id()};
+    for (const auto& [page_id, free] : pages) {
+        fsm.Add(root.data(), page_id, free);
+    }
+    if (!pages.empty()) {
+        reinterpret_cast<FsmPageHeader*>(root.data())->last_page_id = pages.back().first;
+    }
+    return root.page_id();
+}
+
+bool FreeSpaceMap::IsMap(storage::BufferManager* bm, page_id_t page_id) {
+    auto page = bm->read_page(page_id);
+    return reinterpret_cast<const FsmPageHeader*>(page.data())->magic == FSM_MAGIC;
+}
+
+std::optional<FsmSlot> FreeSpaceMap::Find(size_t len) {
+    size_t needed = NeededCategory(len);
+    if (needed > 255) return std::nullopt;
+    uint8_t cat = static_cast<uint8_t>(needed);
+
+    auto root_page = _bm->read_page(_root_page_id);
+    FsmPage root{const_cast<char*>(root_page.data())};
+    auto leaf_no = root.Find(cat);
+    if (!leaf_no.has_value()) return std::nullopt;
+
+    auto leaf_page = _bm->read_page(root.ids[*leaf_no]);
+    FsmPage leaf{const_cast<char*>(leaf_page.data())};
+    auto entry = leaf.Find(cat);
+    if (!entry.has_value()) return std::nullopt;
+    return FsmSlot{*leaf_no * FSM_SLOTS + *entry, leaf.ids[*entry], root.ids[*leaf_no]};
+}
+
+void FreeSpaceMap::Update(const FsmSlot& slot, size_t free) {
+    uint32_t leaf_no = slot.index / FSM_SLOTS;
+    uint32_t entry = slot.index % FSM_SLOTS;
+    page_id_t leaf_id = slot.leaf_page_id;
+    uint8_t cat = Category(free);
+
+    // most inserts leave the category, or at least the maximum of the
+    // leaf, as it was. then the leaf is all that is latched exclusively.
+    bool max_changes;
+    {
+        auto leaf_page = _bm->read_page(leaf_id);
+        FsmPage leaf{const_cast<char*>(leaf_page.data())};
+        if (entry >= leaf.hdr->count || leaf.tree[FSM_SLOTS + entry] == cat) return;
+        max_changes = leaf.MaxWith(entry, cat) != leaf.Max();
+    }
+    if (!max_changes) {
+        auto leaf_page = _bm->write_page(leaf_id);
+        FsmPage leaf{leaf_page.data()};
+        if (leaf.tree[FSM_SLOTS + entry] == cat) return;
+        if (leaf.MaxWith(entry, cat) == leaf.Max()) {
+            leaf.Set(entry, cat);
+            leaf_page.mark_dirty();
+            return;
+        }
+        // another update moved the maximum meanwhile
+    }
+
+    // the root follows the leaf. it is latched first, as by Append()
+    auto root_page = _bm->write_page(_root_page_id);
+    FsmPage root{root_page.data()};
+    auto leaf_page = _bm->write_page(leaf_id);
+    FsmPage leaf{leaf_page.data()};
+    if (leaf.tree[FSM_SLOTS + entry] == cat) return;
+
+    bool max_changed = leaf.Set(entry, cat);
+    leaf_page.mark_dirty();
+    if (max_changed) {
+        root.Set(leaf_no, leaf.Max());
+        root_page.mark_dirty();
+    }
+}
+
+void FreeSpaceMap::Add(char* root_data, page_id_t page_id, size_t free) {
+    FsmPage root{root_data};
+
+    // a new leaf once the last one is full
+    storage::WritePageGuard leaf_page;
+    if (root.hdr->count > 0) {
+        leaf_page = _bm->write_page(root.ids[root.hdr->count - 1]);
+        if (FsmPage{leaf_page.data()}.hdr->count == FSM_SLOTS) leaf_page.release();
+    }
+    if (!leaf_page.valid()) {
+        if (root.hdr->count == FSM_SLOTS) return; // the map is full
+        leaf_page = _bm->new_page(_file_id);
+        FsmPage::Init(leaf_page.data());
+        root.ids[root.hdr->count++] = leaf_page.page_id();
+    }
+
+    FsmPage leaf{leaf_page.data()};
+    uint32_t entry = leaf.hdr->count++;
+    leaf.ids[entry] = page_id;
+    leaf.Set(entry, Category(free));
+    leaf_page.mark_dirty();
+    root.Set(root.hdr->count - 1, leaf.Max());
+}
+}
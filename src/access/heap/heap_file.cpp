@@ -4,7 +4,6 @@
 #include "config/config.h"
 
 using SlottedPage = db::storage::SlottedPage;
-using Frame = db::storage::Frame;
 namespace db::access {
 
 HeapFile::HeapFile(BufferManager* bm, 
@@ -19,19 +18,16 @@ HeapFile::HeapFile(BufferManager* bm,
 void HeapFile::InitHeapPage(char* raw_page) {
     auto* heap_hdr = reinterpret_cast<HeapPageHeader*>(raw_page);
     heap_hdr->next_page_id = INVALID_PAGE_ID;
+    heap_hdr->fsm_page_id = INVALID_PAGE_ID;
     SlottedPage::Init(raw_page, sizeof(HeapPageHeader));
 };
 
-std::optional<Record> HeapFile::Get(const RID& rid) {
-    auto* frame = _bm->request(rid.page_id);
-    if (frame == nullptr) {
-        _bm->release(rid.page_id);
-        return std::nullopt;
-    } 
+std::optional<Record> HeapFile::Get(const RID& rid, db::storage::BufferRing* ring) {
+    auto page = _bm->read_page(rid.page_id, ring);
 
-    auto sp = SlottedPage::FromBuffer(frame->data, sizeof(HeapPageHeader));
+    // SlottedPage has no read-only view; Get() does not modify the page
+    auto sp = SlottedPage::FromBuffer(const_cast<char*>(page.data()), sizeof(HeapPageHeader));
     auto data = sp.Get(rid.slot_id);
-    _bm->release(rid.page_id);
 
     if (data.has_value()) {
         return Record{rid, (*data).first.data(), (*data).second };
@@ -40,113 +36,135 @@ std::optional<Record> HeapFile::Get(const RID& rid) {
     return std::nullopt;
 };
 
-std::optional<RID> HeapFile::Insert(const char* data, size_t len) {
+std::optional<RID> HeapFile::Insert(const char* data, size_t len,
+                                    db::storage::BufferRing* ring) {
     // defensive check for first page id
     if (_first_page_id == INVALID_PAGE_ID) {
-        _first_page_id = _dm->AllocatePage();
-        Frame* first = _bm->request(_first_page_id);
-        InitHeapPage(first->data);
-        _bm->mark_dirty(first);
-        _bm->release(_first_page_id);
+        auto first = _bm->new_page(_file_id);
+        _first_page_id = first.page_id();
+        InitHeapPage(first.data());
     }
 
-    page_id_t page_id = _first_page_id;
-    page_id_t last_page_id = INVALID_PAGE_ID;
-    HeapPageHeader* hdr = nullptr;
-
-    while (page_id != INVALID_PAGE_ID) {
-        Frame* frame = _bm->request(page_id);
-        auto sp = SlottedPage::FromBuffer(frame->data, sizeof(HeapPageHeader));
-
+    // the map rounds free space down, so a page it finds normally fits.
+    // one that does not had its entry overstated; it is corrected, and
+    // the map will not offer that page for this record again.
+    FreeSpaceMap fsm = GetFreeSpaceMap();
+    const size_t needed = len + sizeof(db::storage::Slot);
+    while (auto slot = fsm.Find(needed)) {
+        auto page = _bm->write_page(slot->page_id, ring);
+        auto sp = SlottedPage::FromBuffer(page.data(), sizeof(HeapPageHeader));
         auto slot_id = sp.Insert(data, len);
-        if (slot_id.has_value()) {
-            _bm->mark_dirty(frame);
-            _bm->release(page_id);
-            return RID{page_id, *slot_id};
-        }
+        size_t free = sp.FreeSpace();
+        if (slot_id.has_value()) page.mark_dirty();
+        // the map is latched after the heap page only while appending
+        page.release();
 
-        hdr = reinterpret_cast<HeapPageHeader*>(frame->data);
-        _bm->release(page_id);
-        last_page_id = page_id;
-        page_id = hdr->next_page_id;
+        fsm.Update(*slot, free);
+        if (slot_id.has_value()) return RID{slot->page_id, *slot_id};
     }
 
-    // no page fits
-    page_id_t new_page_id = _dm->AllocatePage();
-
-    // re-fetch last page
-    Frame* last = _bm->request(last_page_id);
-    auto* last_hdr = reinterpret_cast<HeapPageHeader*>(last->data);
-    last_hdr->next_page_id = new_page_id;
-    _bm->mark_dirty(last);
-    _bm->release(last_page_id);
+    // no page fits: try the last page, which the map may not know of,
+    // then link a new one after it
+    std::optional<RID> rid;
+    fsm.Append([&](page_id_t last_page_id) -> std::optional<std::pair<page_id_t, size_t>> {
+        auto page = _bm->write_page(last_page_id, ring);
+        auto sp = SlottedPage::FromBuffer(page.data(), sizeof(HeapPageHeader));
+        if (auto slot_id = sp.Insert(data, len)) {
+            page.mark_dirty();
+            rid = RID{last_page_id, *slot_id};
+            return std::nullopt;
+        }
 
-    // init new page
-    Frame* frame = _bm->request(new_page_id);
-    HeapFile::InitHeapPage(frame->data);
-    _bm->mark_dirty(frame);
+        auto fresh = _bm->new_page(_file_id, ring);
+        page_id_t new_page_id = fresh.page_id();
+        HeapFile::InitHeapPage(fresh.data());
 
-    // insert data into page
-    auto sp = SlottedPage::FromBuffer(frame->data, sizeof(HeapPageHeader));
-    auto slot_id = sp.Insert(data, len);
+        auto* hdr = reinterpret_cast<HeapPageHeader*>(page.data());
+        hdr->next_page_id = new_page_id;
+        page.mark_dirty();
+        page.release();
 
-    if (slot_id.has_value()) {
-        _bm->release(new_page_id);
-        return RID{new_page_id, *slot_id};
-    }
-
-    _bm->release(new_page_id);
+        // insert data into page
+        auto fresh_sp = SlottedPage::FromBuffer(fresh.data(), sizeof(HeapPageHeader));
+        if (auto slot_id = fresh_sp.Insert(data, len)) {
+            rid = RID{new_page_id, *slot_id};
+        }
+        return std::make_pair(new_page_id, fresh_sp.FreeSpace());
+    });
 
-    // at this point, still can't fit into an empty page
-    // return std::nullopt first
+    // nullopt: still can't fit into an empty page
     // future work: implement TOAST
-    return std::nullopt;
+    return rid;
 };
 
 bool HeapFile::Update(const char* new_data, size_t len, const RID& rid) {
-    auto frame = _bm->request(rid.page_id);
-    if (frame == nullptr) {
-        _bm->release(rid.page_id);
-        return false;
-    }
-
-    auto sp = SlottedPage::FromBuffer(frame->data, sizeof(HeapPageHeader));
+    auto page = _bm->write_page(rid.page_id);
+    auto sp = SlottedPage::FromBuffer(page.data(), sizeof(HeapPageHeader));
     bool res = sp.Update(rid.slot_id, new_data, len);
     if (res) {
-        _bm->mark_dirty(frame);
+        page.mark_dirty();
     }
-
-    _bm->release(rid.page_id);
     return res;
 }
 
 bool HeapFile::Delete(const RID& rid) {
-    auto frame = _bm->request(rid.page_id);
-    if (frame == nullptr) {
-        _bm->release(rid.page_id);
-        return false;
-    }
-
-    auto sp = SlottedPage::FromBuffer(frame->data, sizeof(HeapPageHeader));
+    auto page = _bm->write_page(rid.page_id);
+    auto sp = SlottedPage::FromBuffer(page.data(), sizeof(HeapPageHeader));
     bool res = sp.Delete(rid.slot_id);
 
     if (res) {
-        _bm->mark_dirty(frame);
+        page.mark_dirty();
     }
-
-    _bm->release(rid.page_id);
     return res;
 };
 
+FreeSpaceMap HeapFile::GetFreeSpaceMap() {
+    if (_fsm_page_id != INVALID_PAGE_ID) {
+        return FreeSpaceMap{_bm, _file_id, _fsm_page_id};
+    }
+
+    // the first page is not latched while the root is checked: Append()
+    // latches the root before the last page, which may be the first.
+    // files from before the map have 0 in the header, hence the check.
+    page_id_t root;
+    {
+        auto first = _bm->read_page(_first_page_id);
+        root = reinterpret_cast<const HeapPageHeader*>(first.data())->fsm_page_id;
+    }
+    if (root == INVALID_PAGE_ID || !FreeSpaceMap::IsMap(_bm, root)) {
+        // one walk of the chain, with the first page latched so that a
+        // concurrent insert builds no second map
+        auto first = _bm->write_page(_first_page_id);
+        auto* first_hdr = reinterpret_cast<HeapPageHeader*>(first.data());
+        if (first_hdr->fsm_page_id == root) {
+            std::vector<std::pair<page_id_t, size_t>> pages;
+            auto first_sp = SlottedPage::FromBuffer(first.data(), sizeof(HeapPageHeader));
+            pages.emplace_back(_first_page_id, first_sp.FreeSpace());
+            for (page_id_t pid = first_hdr->next_page_id; pid != INVALID_PAGE_ID;) {
+                auto page = _bm->read_page(pid);
+                auto sp = SlottedPage::FromBuffer(const_cast<char*>(page.data()),
+                                                  sizeof(HeapPageHeader));
+                pages.emplace_back(pid, sp.FreeSpace());
+                pid = reinterpret_cast<const HeapPageHeader*>(page.data())->next_page_id;
+            }
+            first_hdr->fsm_page_id = FreeSpaceMap::Build(_bm, _file_id, pages);
+            first.mark_dirty();
+        }
+        root = first_hdr->fsm_page_id;
+    }
+    _fsm_page_id = root;
+    return FreeSpaceMap{_bm, _file_id, root};
+}
+
 BufferManager* HeapFile::GetBm() const {
     return _bm;
 }
 
-HeapIterator HeapFile::begin() {
+HeapIterator HeapFile::begin(db::storage::BufferRing* ring) {
     if (_first_page_id == INVALID_PAGE_ID) {
         return end();
     }
-    return HeapIterator(this, _first_page_id, 0, true);
+    return HeapIterator(this, _first_page_id, 0, true, ring);
 }
 
 HeapIterator HeapFile::end() {
@@ -159,7 +177,7 @@ Record HeapIterator::operator*() {
     }
 
     RID rid{_curr_page, _curr_slot};
-    return _heap->Get(rid).value();
+    return _heap->Get(rid, _ring).value();
 }
 
 HeapIterator& HeapIterator::operator++() {
@@ -172,12 +190,10 @@ HeapIterator& HeapIterator::operator++() {
 HeapFile HeapFile::Create(BufferManager* bm, 
                             DiskManager* dm, 
                             file_id_t fid) {
-    page_id_t pid = dm->AllocatePage();
-    Frame* frame = bm->request(pid);
-    HeapFile hf{bm, dm, fid, pid};
-    hf.InitHeapPage(frame->data);
-    bm->mark_dirty(frame);
-    bm->release(pid);
+    auto page = bm->new_page(fid);
+    HeapFile hf{bm, dm, fid, page.page_id()};
+    hf.InitHeapPage(page.data());
+    page.release();
 
     return hf;
 }
@@ -2,6 +2,8 @@
 #include "access/heap/heap_file.h"
 #include "storage/page/slotted_page.h"
 #include "storage/buffer_manager/frame.h"
+#include "config/config.h"
+#include <algorithm>
 
 using SlottedPage = db::storage::SlottedPage;
 
@@ -9,11 +11,13 @@ namespace db::access {
 HeapIterator::HeapIterator(HeapFile* heap,
                  page_id_t page,
                  uint16_t slot,
-                 bool _has_next)
+                 bool _has_next,
+                 db::storage::BufferRing* ring)
     : _heap(heap),
       _curr_page{page},
       _curr_slot{slot},
-      _has_next{_has_next} {
+      _has_next{_has_next},
+      _ring{ring} {
     
     if (_has_next && _curr_page != INVALID_PAGE_ID) {
         Advance();
@@ -30,7 +34,7 @@ Record HeapIterator::Next() {
     }
 
     RID rid{_curr_page, _curr_slot};
-    auto rec = _heap->Get(rid).value();
+    auto rec = _heap->Get(rid, _ring).value();
 
     _curr_slot++;
     Advance();
@@ -41,27 +45,43 @@ void HeapIterator::Advance() {
     _has_next = false;
 
     while (_curr_page != INVALID_PAGE_ID) {
-        db::storage::Frame* frame = _heap->GetBm()->request(_curr_page);
-        auto sp = SlottedPage::FromBuffer(frame->data, sizeof(HeapPageHeader));
+        auto page = _heap->GetBm()->read_page(_curr_page, _ring);
+        // SlottedPage has no read-only view; nothing here modifies the page
+        auto sp = SlottedPage::FromBuffer(const_cast<char*>(page.data()), sizeof(HeapPageHeader));
 
         while (_curr_slot < sp.GetNumSlots()) {
             if (sp.Get(_curr_slot).has_value()) {
                 _has_next = true;
-                _heap->GetBm()->release(_curr_page);
                 return;
             }
             _curr_slot++;
         }
 
-        auto* hdr = reinterpret_cast<HeapPageHeader*>(frame->data);
+        auto* hdr = reinterpret_cast<const HeapPageHeader*>(page.data());
         page_id_t next = hdr->next_page_id;
 
-        _heap->GetBm()->release(_curr_page);
+        page.release();
+        ReadAhead(next);
         _curr_page = next;
         _curr_slot = 0;
     }
 }
 
+void HeapIterator::ReadAhead(page_id_t next) {
+    // heap pages are allocated from per-file extents, so the next link
+    // usually points at the following page. read ahead while it does,
+    // topping the window up once half of it has been consumed.
+    if (next == INVALID_PAGE_ID || next != _curr_page + 1) return;
+
+    const auto window = static_cast<page_id_t>(db::config::HEAP_READAHEAD_PAGES);
+    if (_readahead_end - next > window / 2) return;
+
+    page_id_t from = std::max(_readahead_end, next + 1);
+    page_id_t to = next + 1 + window;
+    _heap->GetBm()->prefetch(from, static_cast<size_t>(to - from), _ring);
+    _readahead_end = to;
+}
+
 bool HeapIterator::operator==(const HeapIterator& other) const {
     return _heap == other._heap &&
            _curr_page == other._curr_page &&
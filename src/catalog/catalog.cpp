@@ -1,5 +1,6 @@
 #include "catalog/catalog.h"
 #include "config/config.h"
+#include "storage/page/page_checksum.h"
 #include <assert.h>
 #include "util/uuid.h"
 namespace db::catalog {
@@ -32,10 +33,10 @@ table_id_t Catalog::CreateTable(
     
     for (const auto& col : columns) {
         ColumnInfo info{
-                        .col_name = col.col_name,
-                        .ordinal_position = col.ordinal_position,
                         .table_id = table_id,
-                        .type_id = col.type_id };
+                        .col_name = col.col_name,
+                        .type_id = col.type_id,
+                        .ordinal_position = col.ordinal_position };
         _attributes.value().Insert(info);
     }
     return table_id;
@@ -92,36 +93,28 @@ void Catalog::BootstrapCatalogs() {
     char page[config::PAGE_SIZE]{};
     auto* hdr = reinterpret_cast<storage::DBHeaderPage*>(page);
     hdr->magic = config::DB_MAGIC;
+    storage::SetPageChecksum(page);
     _dm->WritePage(pid, reinterpret_cast<const char*>(page));
 
     // db_tables
-    page_id_t p1 = _dm->AllocatePage();
-    assert(p1 == DB_TABLES_ROOT_PAGE_ID);
     {
-        auto* frame1 = _bm->request(p1);
-        access::HeapFile::InitHeapPage(frame1->data);
-        _bm->mark_dirty(frame1);
-        _bm->unpin(frame1);
+        auto root = _bm->new_page();
+        assert(root.page_id() == DB_TABLES_ROOT_PAGE_ID);
+        access::HeapFile::InitHeapPage(root.data());
     }
 
     // db_attributes
-    page_id_t p2 = _dm->AllocatePage();
-    assert(p2 == DB_ATTRIBUTES_ROOT_PAGE_ID);
     {
-        auto* frame2 = _bm->request(p2);
-        access::HeapFile::InitHeapPage(frame2->data);
-        _bm->mark_dirty(frame2);
-        _bm->unpin(frame2);
+        auto root = _bm->new_page();
+        assert(root.page_id() == DB_ATTRIBUTES_ROOT_PAGE_ID);
+        access::HeapFile::InitHeapPage(root.data());
     }
 
     // db_types
-    page_id_t p3 = _dm->AllocatePage();
-    assert(p3 == DB_TYPES_ROOT_PAGE_ID);
     {
-        auto* frame3 = _bm->request(p3);
-        access::HeapFile::InitHeapPage(frame3->data);
-        _bm->mark_dirty(frame3);
-        _bm->unpin(frame3);
+        auto root = _bm->new_page();
+        assert(root.page_id() == DB_TYPES_ROOT_PAGE_ID);
+        access::HeapFile::InitHeapPage(root.data());
     }
 
     _tables.emplace(TablesCatalog(
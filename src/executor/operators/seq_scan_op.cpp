@@ -5,7 +5,7 @@ SeqScanOp::SeqScanOp(model::Relation& rel)
         : _rel{rel} {};
 
 void SeqScanOp::Open() {
-    _iter = _rel.Begin();
+    _iter = _rel.Begin(&_ring);
 }
 
 std::optional<Tuple> SeqScanOp::Next() {
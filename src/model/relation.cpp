@@ -2,13 +2,14 @@
 
 namespace db::model {
 Relation::Relation(HeapFile hf) : _hf{std::move(hf)} {}
-std::optional<RID> Relation::InsertRaw(std::span<const uint8_t> bytes, size_t len) {
+std::optional<RID> Relation::InsertRaw(std::span<const uint8_t> bytes, size_t len,
+                                       storage::BufferRing* ring) {
     // TODO: in the future, to add MVCC tuple header logic into insert raw
     const char* data = reinterpret_cast<const char*>(bytes.data());
-    return _hf.Insert(data, len);
+    return _hf.Insert(data, len, ring);
 };
 
-HeapIterator Relation::Begin() {
-    return _hf.begin();
+HeapIterator Relation::Begin(storage::BufferRing* ring) {
+    return _hf.begin(ring);
 }
 }
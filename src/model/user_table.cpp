@@ -8,9 +8,10 @@ UserTable::UserTable(HeapFile hf, std::vector<ColumnInfo> schema, table_id_t tab
                         _schema{std::move(schema)},
                         _table_id{table_id} {};
 
-std::optional<RID> UserTable::Insert(const std::vector<Value> values) {
+std::optional<RID> UserTable::Insert(const std::vector<Value> values,
+                                     storage::BufferRing* ring) {
     auto bytes = DynamicCodec::Encode(values, _schema);
-    return InsertRaw(bytes, bytes.size());
+    return InsertRaw(bytes, bytes.size(), ring);
 }
 
 Tuple UserTable::Decode(const Record& rec) const {
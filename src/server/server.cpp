@@ -1,10 +1,31 @@
 #include "server/server.h"
 #include "config/config.h"
+#include <chrono>
+#include <exception>
 #include <filesystem>
-#include <format>
+#include <thread>
 
 namespace db::server {
 std::string makePath(std::string db_name);
+std::string makeWarmSetPath(const std::string& db_name);
+
+DbServer::DbServer(size_t pool_size)
+    : _pool{storage::ReplacementPolicyType::CLOCK, nullptr, pool_size} {
+    _writer.emplace(&_pool);
+}
+
+DbServer::~DbServer() {
+    _writer.reset();
+    // views drop their pages without writing them
+    for (auto& [name, bm] : _buffers) {
+        try {
+            bm->flush_all();
+            bm->save_warm_set(makeWarmSetPath(name));
+        } catch (const std::exception&) {
+            // a destructor must not throw; the pages are lost as before
+        }
+    }
+}
 
 void DbServer::Init() {
     for (const auto& entry :
@@ -13,7 +34,9 @@ void DbServer::Init() {
             auto path = entry.path();
             if (path.extension() != ".db") continue;
             std::string name = path.stem().string();
-            _cache[name] = std::make_unique<storage::DiskManager>(path.string());
+            if (_cache.count(name)) continue;
+            Attach(name, std::make_unique<storage::DiskManager>(path.string()));
+            WarmUp(name);
     }
 }
 
@@ -29,10 +52,9 @@ storage::DiskManager* DbServer::OpenDatabase(const std::string& db_name) {
         return nullptr;
     }
 
-    auto dm = std::make_unique<storage::DiskManager>(path);
-    auto* ptr = dm.get();
-    _cache.emplace(db_name, std::move(dm));
-    return ptr;
+    auto* dm = Attach(db_name, std::make_unique<storage::DiskManager>(path));
+    WarmUp(db_name);
+    return dm;
 }
 
 bool DbServer::CreateDatabase(const std::string& db_name) {
@@ -40,22 +62,62 @@ bool DbServer::CreateDatabase(const std::string& db_name) {
     std::string path = makePath(db_name);
     if (std::filesystem::exists(path)) return false;
 
-    auto dm = std::make_unique<storage::DiskManager>(path);
-    _cache.emplace(db_name, std::move(dm));
+    Attach(db_name, std::make_unique<storage::DiskManager>(path));
     return true;
 }
 
 bool DbServer::DeleteDatabase(const std::string& db_name) {
     auto it = _cache.find(db_name);
     if (it == _cache.end()) return false;
+    // the background writer pins pages only for the length of a write.
+    // a guard still held, possibly by the caller, refuses the delete
+    // instead of blocking it forever.
+    auto buffers = _buffers.find(db_name);
+    if (buffers != _buffers.end()) {
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds{config::DELETE_DATABASE_WAIT_MS};
+        while (buffers->second->has_pinned_pages()) {
+            if (std::chrono::steady_clock::now() >= deadline) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+    }
+    _buffers.erase(db_name);
     _cache.erase(it);
     std::string path = makePath(db_name);
     std::filesystem::remove(path);
+    std::filesystem::remove(makeWarmSetPath(db_name));
     return true;
 }
 
+storage::BufferManager* DbServer::GetBufferManager(const std::string& db_name) {
+    auto it = _buffers.find(db_name);
+    return it == _buffers.end() ? nullptr : it->second.get();
+}
+
+size_t DbServer::SaveWarmSet(const std::string& db_name) {
+    storage::BufferManager* bm = GetBufferManager(db_name);
+    return bm ? bm->save_warm_set(makeWarmSetPath(db_name)) : 0;
+}
+
+size_t DbServer::WarmUp(const std::string& db_name) {
+    storage::BufferManager* bm = GetBufferManager(db_name);
+    return bm ? bm->warm_up(makeWarmSetPath(db_name)) : 0;
+}
+
+storage::DiskManager* DbServer::Attach(const std::string& db_name,
+                                       std::unique_ptr<storage::DiskManager> dm) {
+    auto* ptr = dm.get();
+    _buffers[db_name] = std::make_unique<storage::BufferManager>(_pool, ptr);
+    _cache.emplace(db_name, std::move(dm));
+    return ptr;
+}
+
 // util
 std::string makePath(std::string db_name) {
-    return std::format("{}/{}.db", config::DATA_PATH, db_name);
+    return config::DATA_PATH + "/" + db_name + ".db";
+}
+
+std::string makeWarmSetPath(const std::string& db_name) {
+    return config::DATA_PATH + "/" + db_name + ".warm";
 }
 }
\ No newline at end of file
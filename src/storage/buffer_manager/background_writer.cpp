@@ -0,0 +1,32 @@
+#include "storage/buffer_manager/background_writer.h"
+
+namespace db::storage {
+BackgroundWriter::BackgroundWriter(BufferManager* bm, std::chrono::milliseconds delay,
+                                   size_t max_pages)
+    : bm_(bm), delay_(delay), max_pages_(max_pages) {
+    worker_ = std::thread{[this] { Run(); }};
+}
+
+BackgroundWriter::~BackgroundWriter() {
+    {
+        std::lock_guard<std::mutex> lock{mu_};
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+}
+
+void BackgroundWriter::Run() {
+    std::unique_lock<std::mutex> lock{mu_};
+    while (!cv_.wait_for(lock, delay_, [this] { return stopping_; })) {
+        lock.unlock();
+        try {
+            pages_written_ += bm_->write_behind(max_pages_);
+        } catch (...) {
+            // the pages stay dirty; eviction or the next checkpoint
+            // retries the write and reports the error to its caller
+        }
+        lock.lock();
+    }
+}
+}
@@ -1,14 +1,46 @@
 #include "storage/buffer_manager/buffer_manager.h"
+#include "storage/buffer_manager/replacement_policies/arc_policy.h"
 #include "storage/buffer_manager/replacement_policies/clock_policy.h"
+#include "storage/buffer_manager/replacement_policies/lru_k_policy.h"
+#include "storage/buffer_manager/replacement_policies/two_q_policy.h"
+#include "storage/page/page_checksum.h"
 #include "config/config.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <thread>
 
 namespace db::storage {
-BufferManager::BufferManager(ReplacementPolicyType type, IDiskManager* dm)
-    : disk_(dm) {
-    pool_.resize(config::BUFFER_POOL_SIZE);
-    frame_ptrs_.reserve(config::BUFFER_POOL_SIZE);
+namespace {
+// warm set file: magic, page count, then per page its id and whether the
+// policy saw it referenced
+constexpr char WARM_SET_MAGIC[8] = {'B', 'P', 'W', 'A', 'R', 'M', '0', '1'};
+constexpr size_t WARM_SET_RECORD_SIZE = sizeof(page_id_t) + 1;
+}
+
+BufferManager::BufferManager(ReplacementPolicyType type, IDiskManager* dm,
+                             size_t pool_size)
+    : num_shards_(config::BUFFER_POOL_SHARDS), disk_(dm) {
+    if (pool_size == 0) {
+        throw std::invalid_argument("BufferManager: pool size must be at least 1 frame");
+    }
+    if (dm == nullptr) {
+        databases_ = std::make_unique<DatabaseDisks>();
+        disk_ = databases_.get();
+    }
+    map_arena(pool_size);
+
+    page_table_ = std::make_unique<PageTableShard[]>(num_shards_);
+    pool_.resize(pool_size);
+    frame_ptrs_.reserve(pool_size);
 
-    for (size_t i = 0; i < config::BUFFER_POOL_SIZE; ++i) {
+    for (size_t i = 0; i < pool_size; ++i) {
         Frame* f = &pool_[i];
         frame_ptrs_.push_back(f);
 
@@ -16,55 +48,194 @@ BufferManager::BufferManager(ReplacementPolicyType type, IDiskManager* dm)
         f->page_id = INVALID_PAGE_ID;
         f->pin_count = 0;
         f->dirty = 0;
-        f->data = new char[config::PAGE_SIZE];
+        f->data = arena_ + i * config::PAGE_SIZE;
 
         free_list_.add(f);
     }
 
     if (type == ReplacementPolicyType::CLOCK) {
         policy_ = std::make_unique<ClockPolicy>(frame_ptrs_);
+    } else if (type == ReplacementPolicyType::LRU_K) {
+        policy_ = std::make_unique<LRUKPolicy>(frame_ptrs_);
+    } else if (type == ReplacementPolicyType::TWO_Q) {
+        policy_ = std::make_unique<TwoQPolicy>(frame_ptrs_);
+    } else if (type == ReplacementPolicyType::ARC) {
+        policy_ = std::make_unique<ARCPolicy>(frame_ptrs_);
     } else {
+        ::munmap(arena_, arena_len_);
         throw std::runtime_error("BufferManager: Unknown replacement policy type.");
     }
 };
 
-Frame* BufferManager::request(page_id_t pid) {
-    auto it = page_table_.find(pid);
+BufferManager::BufferManager(BufferManager& pool, IDiskManager* dm)
+    : num_shards_(0), disk_(dm), shared_(&pool) {
+    if (pool.databases_ == nullptr) {
+        throw std::invalid_argument("BufferManager: views need a pool created without a disk manager");
+    }
+    slot_ = pool.databases_->attach(dm);
+}
 
-    // case 1: p is in some frame. page hit
-    if (it != page_table_.end()) {
-        Frame* frame = it->second;
-        pin(frame);
-        policy_->record_access(frame);
-        return frame;
+BufferManager::~BufferManager() {
+    if (shared_) {
+        shared_->drop_database(slot_);
+        return;
+    }
+    // prefetch completions still write into the arena. queued warm-ups
+    // are finished first: their frames are pinned and listed as loading
+    {
+        std::lock_guard<std::mutex> lock{warmup_mu_};
+        stopping_ = true;
+    }
+    warmup_cv_.notify_all();
+    if (warmup_.joinable()) warmup_.join();
+    {
+        std::unique_lock<std::mutex> lock{prefetch_mu_};
+        prefetch_cv_.wait(lock, [this] { return prefetches_ == 0; });
     }
+    // dirty pages that were not flushed are lost, as before
+    ::munmap(arena_, arena_len_);
+}
+
+Frame* BufferManager::request(page_id_t pid, BufferRing* ring) {
+    if (shared_) return shared_->request(to_pool(pid), ring);
+    if (trace_.active()) trace_.record(pid, TraceOp::REQUEST);
+    PageTableShard& shard = shard_for(pid);
 
-    Frame* frame = nullptr;
+    // case 1: p is in some frame. page hit
+    for (;;) {
+        std::shared_future<void> loading;
+        {
+            std::lock_guard<std::mutex> lock{shard.mu};
+            auto it = shard.map.find(pid);
+            if (it != shard.map.end()) {
+                Frame* frame = it->second;
+                pin(frame);
+                shard.hits.fetch_add(1, std::memory_order_relaxed);
+                count(pid, &DatabaseDisks::Slot::hits);
+                // re-reading a page the ring loaded (one request per
+                // tuple) is not a reference the policy should count
+                if (ring == nullptr || !ring->holds(frame, pid)) {
+                    policy_->record_access(frame);
+                }
+                return frame;
+            }
+
+            auto pending = shard.loading.find(pid);
+            if (pending == shard.loading.end()) break;
+            loading = pending->second;
+        }
+        // a prefetch is reading p; once it is done p is either cached or
+        // the read failed and is retried below
+        loading.wait();
+    }
 
     // case 2: p is not in some frame
-    // check if free list has available frames
-    if (!free_list_.empty()) {
-        // case 2a: free list is not empty
-        // 1. move some frame f' from freelist to pool
-        // 2. increment pin count of f'
-        // 3. read p into f'
-        // 4. return f'
-        frame = free_list_.get();
-    } else {
-        frame = evict();
+    shard.misses.fetch_add(1, std::memory_order_relaxed);
+    count(pid, &DatabaseDisks::Slot::misses);
+    auto miss_start = std::chrono::steady_clock::now();
+    // 1. take a frame from the ring, the free list, or evict one
+    // 2. read p into it while it is still invisible to other threads
+    // 3. publish it in the page table
+    bool recycled = false;
+    Frame* frame = ring ? ring_victim(*ring, recycled, pid) : evict(pid);
+    try {
+        read(pid, frame);
+    } catch (...) {
+        // give the frame back so a bad page does not leak it
+        discard(frame);
+        throw;
+    }
 
+    {
+        std::lock_guard<std::mutex> lock{shard.mu};
+        auto [it, inserted] = shard.map.try_emplace(pid, frame);
+        if (!inserted) {
+            // another thread loaded p meanwhile; use its copy
+            Frame* existing = it->second;
+            pin(existing);
+            policy_->record_access(existing);
+            discard(frame);
+            miss_latency_.record(std::chrono::steady_clock::now() - miss_start);
+            return existing;
+        }
+        frame->page_id = pid;
+        frame->dirty = 0;
     }
+    count(pid, &DatabaseDisks::Slot::resident);
 
-    pin(frame);
-    read(pid, frame); // loads page + sets page_table_[pid]
-    policy_->record_load(frame);
+    if (ring) {
+        ring->loaded(frame, pid);
+    }
+
+    // recycled ring frames stay out of the policy's rotation
+    if (!recycled) {
+        policy_->record_load(frame);
+    }
+    miss_latency_.record(std::chrono::steady_clock::now() - miss_start);
     return frame;
 }
 
+void BufferManager::prefetch(page_id_t first, size_t n, BufferRing* ring) {
+    if (shared_) return shared_->prefetch(to_pool(first), n, ring);
+    for (size_t i = 0; i < n; ++i) {
+        page_id_t pid = first + static_cast<page_id_t>(i);
+        PageTableShard& shard = shard_for(pid);
+        {
+            std::lock_guard<std::mutex> lock{shard.mu};
+            if (shard.map.contains(pid) || shard.loading.contains(pid)) continue;
+        }
+
+        bool recycled = false;
+        Frame* frame = nullptr;
+        try {
+            frame = ring ? ring_victim(*ring, recycled, pid) : evict(pid);
+        } catch (...) {
+            // no frame to spare (or a victim could not be written back);
+            // the pages will be read on demand
+            return;
+        }
+
+        auto done = std::make_shared<std::promise<void>>();
+        {
+            std::lock_guard<std::mutex> lock{shard.mu};
+            if (shard.map.contains(pid) || shard.loading.contains(pid)) {
+                discard(frame);
+                continue;
+            }
+            shard.loading.emplace(pid, done->get_future().share());
+        }
+        if (ring) {
+            ring->loaded(frame, pid);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{prefetch_mu_};
+            ++prefetches_;
+        }
+        reads_.fetch_add(1, std::memory_order_relaxed);
+        prefetched_.fetch_add(1, std::memory_order_relaxed);
+        count(pid, &DatabaseDisks::Slot::reads);
+        count(pid, &DatabaseDisks::Slot::prefetches);
+        disk_->ReadPageAsync(pid, frame->data,
+                             [this, pid, frame, recycled, done](std::exception_ptr err) {
+            finish_prefetch(pid, frame, recycled, err);
+            done->set_value();
+
+            std::lock_guard<std::mutex> lock{prefetch_mu_};
+            --prefetches_;
+            prefetch_cv_.notify_all();
+        });
+    }
+}
+
 void BufferManager::release(page_id_t pid) {
-    auto it = page_table_.find(pid);
+    if (shared_) return shared_->release(to_pool(pid));
+    if (trace_.active()) trace_.record(pid, TraceOp::RELEASE);
+    PageTableShard& shard = shard_for(pid);
+    std::lock_guard<std::mutex> lock{shard.mu};
+    auto it = shard.map.find(pid);
 
-    if (it == page_table_.end()) {
+    if (it == shard.map.end()) {
         throw std::runtime_error("BufferManager::release(): page not found");
     }
 
@@ -73,67 +244,809 @@ void BufferManager::release(page_id_t pid) {
         throw std::runtime_error("BufferManager::release(): pin count already 0.");
     }
 
-    unpin(f);
-    if (f->pin_count == 0) {
+    if (f->pin_count.fetch_sub(1) == 1) {
         policy_->record_unpin(f);
     }
 }
 
 void BufferManager::mark_dirty(Frame* frame) {
-    frame->dirty = 1;
+    if (shared_) return shared_->mark_dirty(frame);
+    // only the first change since the last write-back enters the dirty
+    // page table; later ones skip the latch
+    if (frame->dirty.load(std::memory_order_relaxed)) return;
+
+    page_id_t pid = frame->page_id;
+    PageTableShard& shard = shard_for(pid);
+    std::lock_guard<std::mutex> lock{shard.mu};
+    set_dirty(shard, frame, pid);
+}
+
+std::vector<std::pair<page_id_t, uint64_t>> BufferManager::dirty_page_table() const {
+    if (shared_) {
+        std::vector<std::pair<page_id_t, uint64_t>> out;
+        for (auto [pid, seq] : shared_->dirty_page_table()) {
+            if (DatabaseDisks::DatabaseOf(pid) == slot_) out.emplace_back(from_pool(pid), seq);
+        }
+        return out;
+    }
+
+    std::vector<std::pair<page_id_t, uint64_t>> out;
+    for (size_t i = 0; i < num_shards_; ++i) {
+        std::lock_guard<std::mutex> lock{page_table_[i].mu};
+        out.insert(out.end(), page_table_[i].dirty.begin(), page_table_[i].dirty.end());
+    }
+    std::sort(out.begin(), out.end());
+    return out;
 }
 
 void BufferManager::flush_all() {
-    for (Frame& f : pool_) {
-        if (f.dirty) flush(&f);
+    if (shared_) return shared_->flush_dirty(slot_);
+    flush_dirty(std::nullopt);
+}
+
+size_t BufferManager::write_behind(size_t max_pages) {
+    if (shared_) return shared_->write_behind(max_pages);
+
+    size_t lookahead = std::max<size_t>(1, pool_.size() * config::BGWRITER_LOOKAHEAD_PERCENT / 100);
+    std::vector<Frame*> upcoming;
+    policy_->upcoming_victims(lookahead, upcoming);
+
+    // claim each page like an eviction victim, but keep it mapped
+    std::vector<Frame*> claimed;
+    for (Frame* f : upcoming) {
+        if (claimed.size() == max_pages) break;
+        if (!f->dirty) continue;
+
+        page_id_t pid = f->page_id;
+        if (pid == INVALID_PAGE_ID) continue;
+        PageTableShard& shard = shard_for(pid);
+        std::lock_guard<std::mutex> lock{shard.mu};
+        auto it = shard.map.find(pid);
+        if (it == shard.map.end() || it->second != f) continue;
+
+        int unpinned = 0;
+        if (!f->pin_count.compare_exchange_strong(unpinned, 1)) continue;
+        claimed.push_back(f);
+    }
+    return write_back(claimed);
+}
+
+size_t BufferManager::save_warm_set(const std::string& path) {
+    if (shared_) return shared_->save_warm_set(path, slot_);
+    return save_warm_set(path, std::nullopt);
+}
+
+size_t BufferManager::save_warm_set(const std::string& path, std::optional<uint32_t> slot) {
+    // the policy lists evictable frames coldest first; pinned pages are
+    // in use and count as hottest
+    std::vector<Frame*> order;
+    policy_->upcoming_victims(pool_.size(), order);
+    std::unordered_map<Frame*, size_t> heat;
+    for (size_t i = 0; i < order.size(); ++i) heat[order[i]] = i;
+
+    struct Entry {
+        page_id_t pid;
+        bool referenced;
+        size_t heat;
+    };
+    std::vector<Entry> entries;
+    for (size_t i = 0; i < num_shards_; ++i) {
+        std::lock_guard<std::mutex> lock{page_table_[i].mu};
+        for (const auto& [pid, f] : page_table_[i].map) {
+            // a view's warm set holds the database's own page ids
+            if (slot && DatabaseDisks::DatabaseOf(pid) != *slot) continue;
+            auto it = heat.find(f);
+            entries.push_back({slot ? DatabaseDisks::PageOf(pid) : pid, policy_->referenced(f),
+                               it == heat.end() ? order.size() : it->second});
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        if (a.referenced != b.referenced) return a.referenced;
+        if (a.heat != b.heat) return a.heat > b.heat;
+        return a.pid < b.pid;
+    });
+
+    // written next to the target and renamed, so a crash leaves the
+    // previous warm set intact
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream out{tmp, std::ios::binary | std::ios::trunc};
+        uint32_t count = static_cast<uint32_t>(entries.size());
+        out.write(WARM_SET_MAGIC, sizeof(WARM_SET_MAGIC));
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        for (const Entry& e : entries) {
+            char rec[WARM_SET_RECORD_SIZE];
+            std::memcpy(rec, &e.pid, sizeof(e.pid));
+            rec[sizeof(e.pid)] = e.referenced ? 1 : 0;
+            out.write(rec, sizeof(rec));
+        }
+        out.close();
+        if (out.fail()) {
+            throw std::runtime_error("BufferManager::save_warm_set(): cannot write " + tmp);
+        }
+    }
+    std::filesystem::rename(tmp, path);
+    return entries.size();
+}
+
+size_t BufferManager::warm_up(const std::string& path) {
+    std::ifstream in{path, std::ios::binary};
+    if (!in) return 0;
+
+    char magic[sizeof(WARM_SET_MAGIC)];
+    uint32_t count = 0;
+    if (!in.read(magic, sizeof(magic))
+        || std::memcmp(magic, WARM_SET_MAGIC, sizeof(magic)) != 0
+        || !in.read(reinterpret_cast<char*>(&count), sizeof(count))) {
+        throw std::runtime_error("BufferManager::warm_up(): " + path + " is not a warm set");
+    }
+    std::vector<page_id_t> pages; // hottest first
+    for (uint32_t i = 0; i < count; ++i) {
+        char rec[WARM_SET_RECORD_SIZE];
+        if (!in.read(rec, sizeof(rec))) {
+            throw std::runtime_error("BufferManager::warm_up(): " + path + " is truncated");
+        }
+        page_id_t pid;
+        std::memcpy(&pid, rec, sizeof(pid));
+        pages.push_back(to_pool(pid));
+    }
+    if (shared_) return shared_->warm_up_pages(pages);
+    return warm_up_pages(pages);
+}
+
+size_t BufferManager::warm_up_pages(const std::vector<page_id_t>& pages) {
+    // take free frames only: a warm-up never evicts, so the hottest
+    // pages are kept if the pool is smaller than before
+    std::vector<WarmupLoad> loads;
+    for (page_id_t pid : pages) {
+        Frame* frame = free_list_.get();
+        if (frame == nullptr) break;
+        pin(frame);
+
+        auto done = std::make_shared<std::promise<void>>();
+        PageTableShard& shard = shard_for(pid);
+        {
+            std::lock_guard<std::mutex> lock{shard.mu};
+            if (shard.map.contains(pid) || shard.loading.contains(pid)) {
+                discard(frame);
+                continue;
+            }
+            shard.loading.emplace(pid, done->get_future().share());
+        }
+        loads.push_back({pid, frame, std::move(done)});
+    }
+    if (loads.empty()) return 0;
+
+    // in page order, so the disk manager can merge neighbours
+    std::sort(loads.begin(), loads.end(),
+              [](const WarmupLoad& a, const WarmupLoad& b) { return a.pid < b.pid; });
+    {
+        std::lock_guard<std::mutex> lock{prefetch_mu_};
+        prefetches_ += loads.size();
+    }
+    reads_.fetch_add(loads.size(), std::memory_order_relaxed);
+    prefetched_.fetch_add(loads.size(), std::memory_order_relaxed);
+    for (const WarmupLoad& l : loads) {
+        count(l.pid, &DatabaseDisks::Slot::reads);
+        count(l.pid, &DatabaseDisks::Slot::prefetches);
+    }
+
+    size_t n = loads.size();
+    {
+        // one worker reads the warm sets of all databases in turn
+        std::lock_guard<std::mutex> lock{warmup_mu_};
+        warmups_.push_back(std::move(loads));
+        if (!warmup_.joinable()) warmup_ = std::thread{&BufferManager::run_warmups, this};
+    }
+    warmup_cv_.notify_one();
+    return n;
+}
+
+void BufferManager::run_warmups() {
+    for (;;) {
+        std::vector<WarmupLoad> loads;
+        {
+            std::unique_lock<std::mutex> lock{warmup_mu_};
+            warmup_cv_.wait(lock, [this] { return stopping_ || !warmups_.empty(); });
+            if (warmups_.empty()) return;
+            loads = std::move(warmups_.front());
+            warmups_.pop_front();
+        }
+
+        for (size_t first = 0; first < loads.size(); first += config::WARMUP_BATCH_PAGES) {
+            size_t last = std::min(loads.size(), first + config::WARMUP_BATCH_PAGES);
+            std::vector<page_id_t> ids;
+            std::vector<char*> buffers;
+            for (size_t i = first; i < last; ++i) {
+                ids.push_back(loads[i].pid);
+                buffers.push_back(loads[i].frame->data);
+            }
+
+            std::exception_ptr err;
+            try {
+                disk_->ReadPages(ids, buffers);
+            } catch (...) {
+                err = std::current_exception();
+            }
+            for (size_t i = first; i < last; ++i) {
+                finish_prefetch(loads[i].pid, loads[i].frame, false, err);
+                loads[i].done->set_value();
+            }
+
+            std::lock_guard<std::mutex> lock{prefetch_mu_};
+            prefetches_ -= last - first;
+            prefetch_cv_.notify_all();
+        }
+    }
+}
+
+ReadPageGuard BufferManager::read_page(page_id_t pid, BufferRing* ring) {
+    Frame* f = request(pid, ring);
+    // only contended acquisitions are timed
+    if (!f->latch.try_lock_shared()) {
+        auto start = std::chrono::steady_clock::now();
+        f->latch.lock_shared();
+        latch_wait_.record(std::chrono::steady_clock::now() - start);
+    }
+    return ReadPageGuard{this, f, pid};
+}
+
+WritePageGuard BufferManager::write_page(page_id_t pid, BufferRing* ring) {
+    Frame* f = request(pid, ring);
+    if (!f->latch.try_lock()) {
+        auto start = std::chrono::steady_clock::now();
+        f->latch.lock();
+        latch_wait_.record(std::chrono::steady_clock::now() - start);
+    }
+    f->begin_write();
+    return WritePageGuard{this, f, pid};
+}
+
+WritePageGuard BufferManager::new_page(BufferRing* ring) {
+    return map_new_page(disk_->AllocatePage(), ring);
+}
+
+WritePageGuard BufferManager::new_page(const config::uuid_t& file_id, BufferRing* ring) {
+    return map_new_page(disk_->AllocateFilePage(file_id), ring);
+}
+
+BufferPoolStats BufferManager::stats() const {
+    if (shared_) {
+        BufferPoolStats out = shared_->database_stats(slot_);
+        latch_wait_.snapshot(out.latch_wait);
+        return out;
+    }
+
+    BufferPoolStats out;
+    out.frames = pool_.size();
+    for (size_t i = 0; i < num_shards_; ++i) {
+        out.hits += page_table_[i].hits.load(std::memory_order_relaxed);
+        out.misses += page_table_[i].misses.load(std::memory_order_relaxed);
     }
+    out.evictions = evictions_.load(std::memory_order_relaxed);
+    out.dirty_evictions = dirty_evictions_.load(std::memory_order_relaxed);
+    out.reads = reads_.load(std::memory_order_relaxed);
+    out.prefetches = prefetched_.load(std::memory_order_relaxed);
+    out.writes = writes_.load(std::memory_order_relaxed);
+    out.new_pages = new_pages_.load(std::memory_order_relaxed);
+    miss_latency_.snapshot(out.miss_latency);
+    latch_wait_.snapshot(out.latch_wait);
+    return out;
 }
 
 // private methods
-Frame* BufferManager::evict() {
-    auto victim = policy_->choose_victim();
+Frame* BufferManager::find_cached(page_id_t pid) {
+    if (shared_) return shared_->find_cached(to_pool(pid));
+
+    PageTableShard& shard = shard_for(pid);
+    std::lock_guard<std::mutex> lock{shard.mu};
+    auto it = shard.map.find(pid);
+    if (it == shard.map.end()) return nullptr;
+    shard.hits.fetch_add(1, std::memory_order_relaxed);
+    count(pid, &DatabaseDisks::Slot::hits);
+    policy_->record_access(it->second);
+    return it->second;
+}
+
+BufferManager::PageTableShard& BufferManager::shard_for(page_id_t pid) {
+    return page_table_[static_cast<uint32_t>(pid) % num_shards_];
+}
+
+void BufferManager::map_arena(size_t pool_size) {
+    // mmap memory is 4 KB aligned, which O_DIRECT reads and writes need.
+    // pools of at least one huge page are also aligned to HUGE_PAGE_SIZE
+    // and advised to use transparent huge pages. that cuts TLB misses when
+    // the pool is many GB.
+    size_t len = pool_size * config::PAGE_SIZE;
+    bool huge = len >= config::HUGE_PAGE_SIZE;
+    size_t slack = huge ? config::HUGE_PAGE_SIZE : 0;
 
-    if (victim == nullptr) {
-        throw std::runtime_error("BufferManager::evict(): no eviction candidates (all frames pinned)");
+    void* map = ::mmap(nullptr, len + slack, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (map == MAP_FAILED) {
+        throw std::runtime_error("BufferManager: cannot map a pool of "
+                                 + std::to_string(pool_size) + " frames");
     }
 
-    if (victim->pin_count != 0) {
-        throw std::runtime_error("BufferManager::evict(): policy selected a pinned frame.");
+    auto base = reinterpret_cast<uintptr_t>(map);
+    uintptr_t start = base;
+    if (huge) start = (base + slack - 1) & ~(uintptr_t{slack} - 1);
+
+    // give back the unaligned head and the tail of the slack
+    if (start > base) ::munmap(map, start - base);
+    size_t tail = base + len + slack - (start + len);
+    if (tail > 0) ::munmap(reinterpret_cast<void*>(start + len), tail);
+
+    arena_ = reinterpret_cast<char*>(start);
+    arena_len_ = len;
+#ifdef MADV_HUGEPAGE
+    // best effort: THP may be disabled
+    if (huge) ::madvise(arena_, arena_len_, MADV_HUGEPAGE);
+#endif
+}
+
+page_id_t BufferManager::to_pool(page_id_t pid) const {
+    if (!shared_ || pid == INVALID_PAGE_ID) return pid;
+    if (pid < 0 || pid > DatabaseDisks::PageOf(-1)) {
+        throw std::out_of_range("BufferManager: page " + std::to_string(pid)
+                                + " is out of range for a shared pool");
     }
+    return DatabaseDisks::PoolPageId(slot_, pid);
+}
 
-    if (victim->dirty) {
-        flush(victim);
+Frame* BufferManager::evict(page_id_t pid) {
+    // concurrent evictors can be handed the same victim; whoever loses
+    // the claim asks the policy again
+    std::vector<Frame*> upcoming;
+    for (size_t attempt = 0; attempt < 2 * pool_.size(); ++attempt) {
+        if (Frame* f = free_list_.get()) {
+            pin(f);
+            return f;
+        }
+
+        Frame* victim = policy_->choose_victim();
+        if (victim == nullptr) break;
+        if (protected_victim(victim, pid)) {
+            // the policy's pick is within another database's reserve;
+            // take the next candidate outside of it, if there is one
+            upcoming.clear();
+            policy_->upcoming_victims(config::FAIR_SHARE_LOOKAHEAD, upcoming);
+            for (Frame* f : upcoming) {
+                if (f != victim && !protected_victim(f, pid) && try_claim(f)) return f;
+            }
+        }
+        if (try_claim(victim)) return victim;
+    }
+
+    throw std::runtime_error("BufferManager::evict(): no eviction candidates (all frames pinned)");
+}
+
+Frame* BufferManager::ring_victim(BufferRing& ring, bool& recycled, page_id_t pid) {
+    // reuse the frame of the ring's oldest page, unless another session
+    // has evicted that page or is still using it
+    Frame* f = ring.frames_[ring.next_];
+    if (f != nullptr && f->page_id == ring.pages_[ring.next_] && try_claim(f)) {
+        recycled = true;
+        return f;
     }
+    return evict(pid);
+}
+
+bool BufferManager::protected_victim(Frame* victim, page_id_t pid) {
+    // a shared pool reserves DATABASE_RESERVED_PERCENT of its frames,
+    // split evenly, so one database scanning cannot push out the working
+    // set of all the others
+    if (databases_ == nullptr) return false;
+    page_id_t victim_pid = victim->page_id.load(std::memory_order_relaxed);
+    if (victim_pid == INVALID_PAGE_ID) return false;
+
+    uint32_t slot = DatabaseDisks::DatabaseOf(victim_pid);
+    if (slot == DatabaseDisks::DatabaseOf(pid)) return false;
+    size_t attached = std::max<size_t>(1, databases_->attached());
+    size_t reserved = pool_.size() * config::DATABASE_RESERVED_PERCENT / 100 / attached;
+    return databases_->slot(slot).resident.load(std::memory_order_relaxed) <= reserved;
+}
+
+bool BufferManager::try_claim(Frame* victim) {
+    // frames without a page are on the free list or being loaded
+    page_id_t old_pid = victim->page_id;
+    if (old_pid == INVALID_PAGE_ID) return false;
 
-    // remove old mapping
-    if (victim->page_id != INVALID_PAGE_ID) {
-        page_table_.erase(victim->page_id);
+    // while the victim's shard is latched nobody can find and pin it
+    PageTableShard& shard = shard_for(old_pid);
+    std::unique_lock<std::mutex> lock{shard.mu};
+    auto it = shard.map.find(old_pid);
+    if (it == shard.map.end() || it->second != victim) return false;
+
+    int unpinned = 0;
+    if (!victim->pin_count.compare_exchange_strong(unpinned, 1)) return false;
+
+    // optimistic readers of the old page fail from here on
+    victim->begin_write();
+    shard.map.erase(it);
+    bool dirty = victim->dirty;
+    if (dirty) {
+        // the page is written without the shard latch. until then it is
+        // listed as loading, so a request for it waits and then reads the
+        // new contents; it stays in the dirty page table until written
+        auto written = std::make_shared<std::promise<void>>();
+        shard.loading.emplace(old_pid, written->get_future().share());
+        lock.unlock();
+        try {
+            flush(victim);
+        } catch (...) {
+            lock.lock();
+            shard.loading.erase(old_pid);
+            shard.map.emplace(old_pid, victim);
+            victim->dirty = 1;
+            lock.unlock();
+            written->set_value();
+            victim->end_write();
+            unpin(victim);
+            throw;
+        }
+        lock.lock();
+        shard.loading.erase(old_pid);
+        shard.dirty.erase(old_pid);
+        written->set_value();
+        dirty_evictions_.fetch_add(1, std::memory_order_relaxed);
+        count(old_pid, &DatabaseDisks::Slot::dirty_evictions);
+    }
+    lock.unlock();
+    evictions_.fetch_add(1, std::memory_order_relaxed);
+    count(old_pid, &DatabaseDisks::Slot::evictions);
+    if (databases_) {
+        databases_->slot(DatabaseDisks::DatabaseOf(old_pid))
+            .resident.fetch_sub(1, std::memory_order_relaxed);
     }
 
     // reset frame metadata
     victim->page_id = INVALID_PAGE_ID;
     victim->dirty = 0;
+    victim->end_write();
+    return true;
+}
+
+void BufferManager::discard(Frame* f) {
+    f->page_id = INVALID_PAGE_ID;
+    f->dirty = 0;
+    f->pin_count = 0;
+    free_list_.add(f);
+}
+
+WritePageGuard BufferManager::map_new_page(page_id_t pid, BufferRing* ring) {
+    if (shared_) {
+        // allocated by the view's disk manager; the guard hands out and
+        // releases the database's own page id
+        WritePageGuard page = shared_->map_new_page(to_pool(pid), ring);
+        page.bm_ = this;
+        page.pid_ = pid;
+        return page;
+    }
+
+    // the page has never been written, so there is nothing to read
+    bool recycled = false;
+    Frame* frame = ring ? ring_victim(*ring, recycled, pid) : evict(pid);
+    std::memset(frame->data, 0, config::PAGE_SIZE);
+    frame->latch.lock();
+    frame->begin_write();
+
+    Frame* stale = nullptr;
+    PageTableShard& shard = shard_for(pid);
+    {
+        std::lock_guard<std::mutex> lock{shard.mu};
+        auto [it, inserted] = shard.map.try_emplace(pid, frame);
+        if (inserted) {
+            frame->page_id = pid;
+            set_dirty(shard, frame, pid);
+        } else {
+            stale = it->second;
+            pin(stale);
+            set_dirty(shard, stale, pid);
+        }
+    }
+
+    if (stale != nullptr) {
+        // a copy is cached already, e.g. read ahead past the end of the
+        // file or left over from before the page was deallocated
+        frame->end_write();
+        frame->latch.unlock();
+        discard(frame);
+        stale->latch.lock();
+        stale->begin_write();
+        std::memset(stale->data, 0, config::PAGE_SIZE);
+        policy_->record_access(stale);
+        new_pages_.fetch_add(1, std::memory_order_relaxed);
+        count(pid, &DatabaseDisks::Slot::new_pages);
+        return WritePageGuard{this, stale, pid};
+    }
+
+    if (ring) {
+        ring->loaded(frame, pid);
+    }
+    if (!recycled) {
+        policy_->record_load(frame);
+    }
+    new_pages_.fetch_add(1, std::memory_order_relaxed);
+    count(pid, &DatabaseDisks::Slot::new_pages);
+    count(pid, &DatabaseDisks::Slot::resident);
+    return WritePageGuard{this, frame, pid};
+}
+
+void BufferManager::finish_prefetch(page_id_t pid, Frame* f, bool recycled,
+                                    std::exception_ptr err) {
+    bool ok = err == nullptr && (!verify_checksums_ || VerifyPageChecksum(f->data));
+
+    PageTableShard& shard = shard_for(pid);
+    bool published = false;
+    {
+        std::lock_guard<std::mutex> lock{shard.mu};
+        shard.loading.erase(pid);
+        if (ok && shard.map.try_emplace(pid, f).second) {
+            f->page_id = pid;
+            f->dirty = 0;
+            published = true;
+        }
+    }
+    if (published) count(pid, &DatabaseDisks::Slot::resident);
 
-    return victim;
+    // a page that failed to read is left for request() to report
+    if (!published) {
+        discard(f);
+        return;
+    }
+    if (!recycled) {
+        policy_->record_load(f);
+    }
+    // drop the pin evict() took without record_unpin(): nobody has used
+    // the page yet, and CLOCK would make it the next victim
+    unpin(f);
+}
+
+void BufferManager::set_verify_checksums(bool enabled) {
+    if (shared_) return shared_->set_verify_checksums(enabled);
+    verify_checksums_ = enabled;
 }
 
 void BufferManager::read(page_id_t pid, Frame* f) {
+    reads_.fetch_add(1, std::memory_order_relaxed);
+    count(pid, &DatabaseDisks::Slot::reads);
     disk_->ReadPage(pid, f->data);
-    page_table_[pid] = f;
-    f->page_id = pid;
-    f->dirty = 0;
+    if (verify_checksums_ && !VerifyPageChecksum(f->data)) {
+        throw std::runtime_error("BufferManager::read(): checksum mismatch on page "
+                                 + std::to_string(pid));
+    }
+}
+
+size_t BufferManager::write_back(const std::vector<Frame*>& pinned) {
+    // copy each dirty page under a shared frame latch, so a writer holding
+    // a WritePageGuard finishes first, and clear its dirty flag. the
+    // copies are written without latches in one batch in page order. the
+    // frames stay pinned until then, so they cannot be evicted and read
+    // back before the disk has the new contents. a session that changes
+    // a page meanwhile marks it dirty again.
+    //
+    // a page stays in the dirty page table until its write is done, so a
+    // checkpoint sees it, and is listed as being written. a write-back of
+    // the same page waits for that write, so writes land in order.
+    auto done = std::make_shared<std::promise<void>>();
+    std::shared_future<void> writing = done->get_future().share();
+    std::vector<Frame*> written;
+    std::vector<char> copies;
+    for (Frame* f : pinned) {
+        page_id_t pid = f->page_id;
+        PageTableShard& shard = shard_for(pid);
+        std::shared_lock<std::shared_mutex> latch{f->latch, std::defer_lock};
+        std::unique_lock<std::mutex> lock{shard.mu, std::defer_lock};
+        for (;;) {
+            latch.lock();
+            lock.lock();
+            auto in_flight = shard.writing.find(pid);
+            if (in_flight == shard.writing.end()) break;
+            std::shared_future<void> earlier = in_flight->second;
+            lock.unlock();
+            latch.unlock();
+            earlier.wait();
+        }
+        if (!f->dirty) continue;
+
+        copies.insert(copies.end(), f->data, f->data + config::PAGE_SIZE);
+        f->dirty = 0;
+        shard.writing.emplace(pid, writing);
+        written.push_back(f);
+    }
+
+    std::vector<size_t> order(written.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&written](size_t a, size_t b) {
+        return written[a]->page_id < written[b]->page_id;
+    });
+
+    std::vector<page_id_t> ids;
+    std::vector<const char*> pages;
+    ids.reserve(order.size());
+    pages.reserve(order.size());
+    for (size_t i : order) {
+        char* copy = copies.data() + i * config::PAGE_SIZE;
+        SetPageChecksum(copy);
+        ids.push_back(written[i]->page_id);
+        pages.push_back(copy);
+    }
+
+    std::exception_ptr err;
+    try {
+        if (!ids.empty()) disk_->WritePages(ids, pages);
+    } catch (...) {
+        err = std::current_exception();
+    }
+    for (Frame* f : written) {
+        // the entry goes once the page is on disk, unless it was changed
+        // again meanwhile; a failed page is dirty again under its entry
+        page_id_t pid = f->page_id;
+        PageTableShard& shard = shard_for(pid);
+        std::lock_guard<std::mutex> lock{shard.mu};
+        shard.writing.erase(pid);
+        if (err) {
+            f->dirty = 1;
+        } else if (!f->dirty) {
+            shard.dirty.erase(pid);
+        }
+    }
+    done->set_value();
+    for (Frame* f : pinned) unpin(f);
+    if (err) std::rethrow_exception(err);
+
+    writes_.fetch_add(ids.size(), std::memory_order_relaxed);
+    for (page_id_t pid : ids) count(pid, &DatabaseDisks::Slot::writes);
+    return written.size();
+}
+
+void BufferManager::flush_dirty(std::optional<uint32_t> slot) {
+    // pin every dirty page under the shard latches (in index order), so
+    // none is evicted or remapped while the checkpoint is written
+    std::vector<Frame*> dirty;
+    std::vector<std::shared_future<void>> evicting;
+    {
+        std::vector<std::unique_lock<std::mutex>> locks;
+        locks.reserve(num_shards_);
+        for (size_t i = 0; i < num_shards_; ++i) {
+            locks.emplace_back(page_table_[i].mu);
+        }
+        // the dirty page table lists them, so the cost follows the
+        // number of dirty pages rather than the pool size
+        for (size_t i = 0; i < num_shards_; ++i) {
+            const PageTableShard& shard = page_table_[i];
+            for (auto& [pid, first_dirtied] : shard.dirty) {
+                if (slot && DatabaseDisks::DatabaseOf(pid) != *slot) continue;
+                auto it = shard.map.find(pid);
+                if (it == shard.map.end()) {
+                    // an eviction is writing it; wait for that write
+                    evicting.push_back(shard.loading.at(pid));
+                    continue;
+                }
+                pin(it->second);
+                dirty.push_back(it->second);
+            }
+        }
+    }
+    write_back(dirty);
+    for (const auto& written : evicting) written.wait();
+
+    // individual writes are not flushed; make them durable once here
+    if (slot) {
+        databases_->slot(*slot).disk.load()->Sync();
+    } else {
+        disk_->Sync();
+    }
+}
+
+void BufferManager::count(page_id_t pid, std::atomic<uint64_t> DatabaseDisks::Slot::*counter,
+                          uint64_t n) {
+    if (databases_ == nullptr) return;
+    (databases_->slot(DatabaseDisks::DatabaseOf(pid)).*counter).fetch_add(n, std::memory_order_relaxed);
+}
+
+BufferPoolStats BufferManager::database_stats(uint32_t slot) const {
+    const DatabaseDisks::Slot& s = databases_->slot(slot);
+    BufferPoolStats out;
+    out.frames = s.resident.load(std::memory_order_relaxed);
+    out.hits = s.hits.load(std::memory_order_relaxed);
+    out.misses = s.misses.load(std::memory_order_relaxed);
+    out.evictions = s.evictions.load(std::memory_order_relaxed);
+    out.dirty_evictions = s.dirty_evictions.load(std::memory_order_relaxed);
+    out.reads = s.reads.load(std::memory_order_relaxed);
+    out.prefetches = s.prefetches.load(std::memory_order_relaxed);
+    out.writes = s.writes.load(std::memory_order_relaxed);
+    out.new_pages = s.new_pages.load(std::memory_order_relaxed);
+    return out;
+}
+
+void BufferManager::drop_database(uint32_t slot) {
+    // reads of the database still in flight would land in frames given
+    // back below
+    {
+        std::unique_lock<std::mutex> lock{prefetch_mu_};
+        prefetch_cv_.wait(lock, [this] { return prefetches_ == 0; });
+    }
+
+    // each frame is claimed like an eviction victim, without the write.
+    // frames still pinned, by a guard or a write-back, and evictions
+    // writing a page of the database are waited for.
+    for (;;) {
+        bool pinned = false;
+        std::vector<std::shared_future<void>> writes;
+        for (size_t i = 0; i < num_shards_; ++i) {
+            PageTableShard& shard = page_table_[i];
+            std::lock_guard<std::mutex> lock{shard.mu};
+            for (const auto& [pid, written] : shard.loading) {
+                if (DatabaseDisks::DatabaseOf(pid) == slot) writes.push_back(written);
+            }
+            for (auto it = shard.map.begin(); it != shard.map.end();) {
+                if (DatabaseDisks::DatabaseOf(it->first) != slot) {
+                    ++it;
+                    continue;
+                }
+                Frame* f = it->second;
+                int unpinned = 0;
+                if (!f->pin_count.compare_exchange_strong(unpinned, 1)) {
+                    pinned = true;
+                    ++it;
+                    continue;
+                }
+                f->begin_write();
+                shard.dirty.erase(it->first);
+                it = shard.map.erase(it);
+                f->page_id = INVALID_PAGE_ID;
+                f->dirty = 0;
+                f->end_write();
+                discard(f);
+                databases_->slot(slot).resident.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+        if (!pinned && writes.empty()) break;
+        for (const auto& written : writes) written.wait();
+        if (pinned) std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    databases_->detach(slot);
+}
+
+bool BufferManager::has_pinned_pages() const {
+    if (shared_) return shared_->has_pinned_pages(slot_);
+    return has_pinned_pages(std::nullopt);
+}
+
+bool BufferManager::has_pinned_pages(std::optional<uint32_t> slot) const {
+    for (size_t i = 0; i < num_shards_; ++i) {
+        std::lock_guard<std::mutex> lock{page_table_[i].mu};
+        for (const auto& [pid, f] : page_table_[i].map) {
+            if (slot && DatabaseDisks::DatabaseOf(pid) != *slot) continue;
+            if (f->pin_count.load() != 0) return true;
+        }
+    }
+    return false;
+}
+
+void BufferManager::set_dirty(PageTableShard& shard, Frame* f, page_id_t pid) {
+    if (f->dirty) return;
+    f->dirty = 1;
+    // a page changed while its write-back is in flight keeps the older
+    // entry, which is the safe side for a checkpoint
+    shard.dirty.emplace(pid, dirty_seq_.fetch_add(1, std::memory_order_relaxed) + 1);
 }
 
 void BufferManager::flush(Frame* f) {
+    SetPageChecksum(f->data);
     disk_->WritePage(f->page_id, f->data);
+    writes_.fetch_add(1, std::memory_order_relaxed);
+    count(f->page_id, &DatabaseDisks::Slot::writes);
     f->dirty = 0;
 }
 
 void BufferManager::pin(Frame* f) {
-    ++f->pin_count;
+    f->pin_count.fetch_add(1);
 }
 
 void BufferManager::unpin(Frame* f) {
-    --f->pin_count;
+    f->pin_count.fetch_sub(1);
+}
 }
-}
\ No newline at end of file
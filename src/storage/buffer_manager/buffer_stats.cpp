@@ -0,0 +1,78 @@
+#include "storage/buffer_manager/buffer_stats.h"
+#include <algorithm>
+#include <bit>
+#include <iomanip>
+#include <sstream>
+
+namespace db::storage {
+size_t Histogram::bucket_of(uint64_t us) {
+    return std::min<size_t>(std::bit_width(us), BUCKETS - 1);
+}
+
+double Histogram::mean_us() const {
+    return count == 0 ? 0.0 : static_cast<double>(total_us) / count;
+}
+
+uint64_t Histogram::percentile_us(double p) const {
+    if (count == 0) return 0;
+
+    // rank of the sample, rounded up
+    auto rank = static_cast<uint64_t>(p / 100.0 * count);
+    if (rank * 100.0 < p * count) ++rank;
+    rank = std::clamp<uint64_t>(rank, 1, count);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) return bucket_limit(i);
+    }
+    return bucket_limit(BUCKETS - 1);
+}
+
+double BufferPoolStats::hit_ratio() const {
+    uint64_t requests = hits + misses;
+    return requests == 0 ? 0.0 : static_cast<double>(hits) / requests;
+}
+
+std::string BufferPoolStats::to_string() const {
+    auto latency = [](std::ostream& out, const char* name, const Histogram& h) {
+        out << "  " << name << ": " << h.count;
+        if (h.count != 0) {
+            out << ", mean " << h.mean_us() << " us"
+                << ", p50 < " << h.percentile_us(50) << " us"
+                << ", p99 < " << h.percentile_us(99) << " us"
+                << ", max < " << h.percentile_us(100) << " us";
+        }
+        out << "\n";
+    };
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    out << "buffer pool: " << frames << " frames\n"
+        << "  requests: " << hits + misses << " (" << hits << " hits, "
+        << misses << " misses, hit ratio " << hit_ratio() * 100 << "%)\n"
+        << "  evictions: " << evictions << " (" << dirty_evictions << " dirty)\n"
+        << "  reads: " << reads << " (" << prefetches << " prefetched)\n"
+        << "  new pages: " << new_pages << "\n"
+        << "  writes: " << writes << "\n";
+    latency(out, "miss latency", miss_latency);
+    latency(out, "latch waits", latch_wait);
+    return out.str();
+}
+
+void AtomicHistogram::record(std::chrono::nanoseconds latency) {
+    auto us = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+    buckets_[Histogram::bucket_of(us)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    total_us_.fetch_add(us, std::memory_order_relaxed);
+}
+
+void AtomicHistogram::snapshot(Histogram& out) const {
+    for (size_t i = 0; i < Histogram::BUCKETS; ++i) {
+        out.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    }
+    out.count = count_.load(std::memory_order_relaxed);
+    out.total_us = total_us_.load(std::memory_order_relaxed);
+}
+}
@@ -0,0 +1,86 @@
+#include "storage/buffer_manager/buffer_trace.h"
+#include "config/config.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace db::storage {
+BufferTrace::~BufferTrace() {
+    try {
+        stop();
+    } catch (...) {
+        // a destructor must not throw; the tail of the trace is lost
+    }
+}
+
+void BufferTrace::start(const std::string& path) {
+    std::lock_guard<std::mutex> lock{mu_};
+    if (out_.is_open()) {
+        throw std::runtime_error("BufferTrace: a trace is running already");
+    }
+    out_.open(path, std::ios::binary | std::ios::trunc);
+    if (!out_) {
+        throw std::runtime_error("BufferTrace: cannot open " + path);
+    }
+    out_.write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    buffer_.reserve(config::TRACE_BUFFER_RECORDS * TRACE_RECORD_SIZE);
+    started_ = std::chrono::steady_clock::now();
+    active_.store(true, std::memory_order_relaxed);
+}
+
+void BufferTrace::stop() {
+    std::lock_guard<std::mutex> lock{mu_};
+    if (!out_.is_open()) return;
+    active_.store(false, std::memory_order_relaxed);
+
+    write_buffer();
+    out_.close();
+    if (out_.fail()) {
+        throw std::runtime_error("BufferTrace: cannot write the trace");
+    }
+}
+
+void BufferTrace::record(page_id_t pid, TraceOp op) {
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock{mu_};
+    if (!out_.is_open()) return; // stopped meanwhile
+
+    uint64_t micros = std::chrono::duration_cast<std::chrono::microseconds>(
+        now - started_).count();
+    char rec[TRACE_RECORD_SIZE];
+    std::memcpy(rec, &pid, sizeof(pid));
+    rec[sizeof(pid)] = static_cast<char>(op);
+    std::memcpy(rec + sizeof(pid) + 1, &micros, sizeof(micros));
+    buffer_.insert(buffer_.end(), rec, rec + TRACE_RECORD_SIZE);
+
+    if (buffer_.size() >= config::TRACE_BUFFER_RECORDS * TRACE_RECORD_SIZE) {
+        write_buffer();
+    }
+}
+
+void BufferTrace::write_buffer() {
+    out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+}
+
+TraceReader::TraceReader(const std::string& path)
+    : in_{path, std::ios::binary} {
+    if (!in_) {
+        throw std::runtime_error("TraceReader: cannot open " + path);
+    }
+    char magic[sizeof(TRACE_MAGIC)];
+    if (!in_.read(magic, sizeof(magic))
+        || std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0) {
+        throw std::runtime_error("TraceReader: " + path + " is not a buffer pool trace");
+    }
+}
+
+bool TraceReader::next(TraceRecord& out) {
+    char rec[TRACE_RECORD_SIZE];
+    if (!in_.read(rec, TRACE_RECORD_SIZE)) return false;
+
+    std::memcpy(&out.page_id, rec, sizeof(out.page_id));
+    out.op = static_cast<TraceOp>(rec[sizeof(out.page_id)]);
+    std::memcpy(&out.micros, rec + sizeof(out.page_id) + 1, sizeof(out.micros));
+    return true;
+}
+}
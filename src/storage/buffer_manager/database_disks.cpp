@@ -0,0 +1,125 @@
+#include "storage/buffer_manager/database_disks.h"
+#include "storage/buffer_manager/frame.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace db::storage {
+namespace {
+// calls `io(pool page id, ids, pages)` once per run of pages of the
+// same database, with the database's own page ids in `ids`
+template <typename Page, typename IO>
+void ForEachDatabase(std::span<const page_id_t> page_ids, std::span<Page> pages, IO&& io) {
+    size_t first = 0;
+    while (first < page_ids.size()) {
+        uint32_t slot = DatabaseDisks::DatabaseOf(page_ids[first]);
+        size_t last = first;
+        std::vector<page_id_t> ids;
+        while (last < page_ids.size() && DatabaseDisks::DatabaseOf(page_ids[last]) == slot) {
+            ids.push_back(DatabaseDisks::PageOf(page_ids[last]));
+            ++last;
+        }
+        io(page_ids[first], std::span<const page_id_t>{ids}, pages.subspan(first, last - first));
+        first = last;
+    }
+}
+}
+
+DatabaseDisks::DatabaseDisks() : slots_{std::make_unique<Slot[]>(MAX_DATABASES)} {}
+
+uint32_t DatabaseDisks::attach(IDiskManager* dm) {
+    std::lock_guard<std::mutex> lock{mu_};
+    for (uint32_t i = 0; i < MAX_DATABASES; ++i) {
+        Slot& s = slots_[i];
+        if (s.disk.load() != nullptr) continue;
+
+        for (auto* counter : {&s.resident, &s.hits, &s.misses, &s.evictions, &s.dirty_evictions,
+                              &s.reads, &s.prefetches, &s.writes, &s.new_pages}) {
+            counter->store(0, std::memory_order_relaxed);
+        }
+        s.disk.store(dm);
+        attached_.fetch_add(1, std::memory_order_relaxed);
+        return i;
+    }
+    throw std::runtime_error("DatabaseDisks: no free slot, at most "
+                             + std::to_string(MAX_DATABASES) + " databases");
+}
+
+void DatabaseDisks::detach(uint32_t slot) {
+    std::lock_guard<std::mutex> lock{mu_};
+    if (slots_[slot].disk.exchange(nullptr) != nullptr) {
+        attached_.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+void DatabaseDisks::ReadPage(page_id_t page_id, char* page_data) {
+    disk_of(page_id)->ReadPage(PageOf(page_id), page_data);
+}
+
+void DatabaseDisks::WritePage(page_id_t page_id, const char* page_data) {
+    disk_of(page_id)->WritePage(PageOf(page_id), page_data);
+}
+
+void DatabaseDisks::ReadPages(std::span<const page_id_t> page_ids,
+                              std::span<char* const> pages) {
+    ForEachDatabase(page_ids, pages, [this](page_id_t any, auto ids, auto run) {
+        disk_of(any)->ReadPages(ids, run);
+    });
+}
+
+void DatabaseDisks::WritePages(std::span<const page_id_t> page_ids,
+                               std::span<const char* const> pages) {
+    ForEachDatabase(page_ids, pages, [this](page_id_t any, auto ids, auto run) {
+        disk_of(any)->WritePages(ids, run);
+    });
+}
+
+void DatabaseDisks::ReadPageAsync(page_id_t page_id, char* page_data, IOCallback on_complete) {
+    IDiskManager* dm = nullptr;
+    try {
+        dm = disk_of(page_id);
+    } catch (...) {
+        on_complete(std::current_exception());
+        return;
+    }
+    dm->ReadPageAsync(PageOf(page_id), page_data, std::move(on_complete));
+}
+
+void DatabaseDisks::WritePageAsync(page_id_t page_id, const char* page_data, IOCallback on_complete) {
+    IDiskManager* dm = nullptr;
+    try {
+        dm = disk_of(page_id);
+    } catch (...) {
+        on_complete(std::current_exception());
+        return;
+    }
+    dm->WritePageAsync(PageOf(page_id), page_data, std::move(on_complete));
+}
+
+page_id_t DatabaseDisks::AllocatePage() {
+    throw std::logic_error("DatabaseDisks: allocate pages through a database's BufferManager view");
+}
+
+page_id_t DatabaseDisks::AllocateFilePage(const config::uuid_t&) {
+    return AllocatePage();
+}
+
+void DatabaseDisks::DeallocatePage(page_id_t page_id) {
+    disk_of(page_id)->DeallocatePage(PageOf(page_id));
+}
+
+void DatabaseDisks::Sync() {
+    for (uint32_t i = 0; i < MAX_DATABASES; ++i) {
+        if (IDiskManager* dm = slots_[i].disk.load()) dm->Sync();
+    }
+}
+
+IDiskManager* DatabaseDisks::disk_of(page_id_t pid) {
+    IDiskManager* dm = pid == INVALID_PAGE_ID ? nullptr : slots_[DatabaseOf(pid)].disk.load();
+    if (dm == nullptr) {
+        throw std::runtime_error("DatabaseDisks: no database attached for page "
+                                 + std::to_string(pid));
+    }
+    return dm;
+}
+}
@@ -6,11 +6,13 @@ namespace db::storage {
 FreeList::FreeList() = default;
 
 void FreeList::add(Frame* frame) {
+    std::lock_guard<std::mutex> lock{mu_};
     list_.push_back(frame);
 };
 
 Frame* FreeList::get() {
-    if (empty()) {
+    std::lock_guard<std::mutex> lock{mu_};
+    if (list_.empty()) {
         return nullptr;
     }
 
@@ -20,10 +22,12 @@ Frame* FreeList::get() {
 };
 
 size_t FreeList::size() const noexcept {
+    std::lock_guard<std::mutex> lock{mu_};
     return list_.size();
 };
 
 bool FreeList::empty() const noexcept {
+    std::lock_guard<std::mutex> lock{mu_};
     return list_.empty();
 };
 }
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "storage/buffer_manager/page_guard.h"
+#include "storage/buffer_manager/buffer_manager.h"
+
+namespace db::storage {
+PageGuard::PageGuard(PageGuard&& other) noexcept {
+    take(other);
+}
+
+void PageGuard::take(PageGuard& other) noexcept {
+    bm_ = other.bm_;
+    frame_ = other.frame_;
+    pid_ = other.pid_;
+    other.bm_ = nullptr;
+    other.frame_ = nullptr;
+    other.pid_ = INVALID_PAGE_ID;
+}
+
+void PageGuard::drop(bool exclusive) {
+    if (frame_ == nullptr) return;
+
+    // unlatch before unpinning: once unpinned the frame may be reused
+    if (exclusive) {
+        frame_->end_write();
+        frame_->latch.unlock();
+    } else {
+        frame_->latch.unlock_shared();
+    }
+    bm_->release(pid_);
+
+    bm_ = nullptr;
+    frame_ = nullptr;
+    pid_ = INVALID_PAGE_ID;
+}
+
+ReadPageGuard& ReadPageGuard::operator=(ReadPageGuard&& other) noexcept {
+    if (this != &other) {
+        release();
+        take(other);
+    }
+    return *this;
+}
+
+void WritePageGuard::mark_dirty() {
+    bm_->mark_dirty(frame_);
+}
+
+WritePageGuard& WritePageGuard::operator=(WritePageGuard&& other) noexcept {
+    if (this != &other) {
+        release();
+        take(other);
+    }
+    return *this;
+}
+}
@@ -0,0 +1,206 @@
+#include "storage/buffer_manager/replacement_policies/arc_policy.h"
+#include <algorithm>
+
+namespace db::storage {
+ARCPolicy::ARCPolicy(std::vector<Frame*>& frames, uint64_t correlated_period)
+    : c_{frames.size()}, correlated_period_{correlated_period}, frames_{frames} {
+    slots_.resize(frames.size());
+    for (size_t i = 0; i < frames.size(); ++i) {
+        frame_idx_[frames[i]] = i;
+        untracked_.insert(i);
+    }
+}
+
+Frame* ARCPolicy::choose_victim() {
+    std::lock_guard<std::mutex> lock{mu_};
+
+    for (size_t i : untracked_) {
+        if (frames_[i]->pin_count == 0) return frames_[i];
+    }
+
+    // REPLACE: take from T1 while it exceeds its target. the page about to
+    // be loaded is not known yet, so the paper's tie-break for a load that
+    // hits B2 with |T1| == p is left out.
+    if (t1_.size() > p_) {
+        if (Frame* f = lru_unpinned(t1_)) return f;
+        return lru_unpinned(t2_);
+    }
+    if (Frame* f = lru_unpinned(t2_)) return f;
+    return lru_unpinned(t1_);
+}
+
+void ARCPolicy::upcoming_victims(size_t n, std::vector<Frame*>& out) {
+    std::lock_guard<std::mutex> lock{mu_};
+
+    // replay choose_victim() against the current queues: take from
+    // T1 while it stays above p, otherwise from T2
+    auto first = t1_.rbegin();
+    auto second = t2_.rbegin();
+    size_t first_left = t1_.size();
+    size_t taken = 0;
+    while (taken < n && (first != t1_.rend() || second != t2_.rend())) {
+        bool from_first = second == t2_.rend()
+            || (first != t1_.rend() && first_left > p_);
+        size_t idx = from_first ? *first++ : *second++;
+        if (from_first) --first_left;
+
+        Frame* f = frames_[idx];
+        if (f->pin_count != 0) continue;
+        out.push_back(f);
+        ++taken;
+    }
+}
+
+bool ARCPolicy::referenced(Frame* f) {
+    std::lock_guard<std::mutex> lock{mu_};
+    const Slot& s = slots_[frame_idx_.at(f)];
+    return s.page_id == f->page_id && s.queue == Queue::T2;
+}
+
+void ARCPolicy::record_access(Frame* f) {
+    // page HIT
+    std::lock_guard<std::mutex> lock{mu_};
+    size_t idx = frame_idx_.at(f);
+    page_id_t pid = f->page_id;
+
+    // a hit can be reported before the load of a frame that was just
+    // published by another thread
+    if (slots_[idx].page_id != pid) {
+        load(idx, pid);
+        return;
+    }
+    touch(idx);
+}
+
+void ARCPolicy::record_load(Frame* f) {
+    // page LOAD into frame
+    std::lock_guard<std::mutex> lock{mu_};
+    size_t idx = frame_idx_.at(f);
+    page_id_t pid = f->page_id;
+
+    if (slots_[idx].page_id == pid) {
+        touch(idx);
+        return;
+    }
+    load(idx, pid);
+}
+
+void ARCPolicy::record_unpin(Frame*) {
+    // ARC orders pages by references only
+}
+
+size_t ARCPolicy::target() const {
+    std::lock_guard<std::mutex> lock{mu_};
+    return p_;
+}
+
+// private methods
+void ARCPolicy::load(size_t idx, page_id_t pid) {
+    ++now_;
+    forget(idx);
+
+    Slot& s = slots_[idx];
+    s.page_id = pid;
+    s.last = now_;
+
+    auto ghost = ghosts_.find(pid);
+    if (ghost == ghosts_.end()) {
+        // not seen recently
+        t1_.push_front(idx);
+        s.queue = Queue::T1;
+        s.pos = t1_.begin();
+    } else {
+        // the page was evicted too early: shift the target towards the
+        // list that would have kept it, faster if that ghost list is small
+        if (ghost->second.queue == Queue::B1) {
+            size_t delta = b1_.size() >= b2_.size() ? 1 : b2_.size() / b1_.size();
+            p_ = std::min(c_, p_ + delta);
+            b1_.erase(ghost->second.pos);
+        } else {
+            size_t delta = b2_.size() >= b1_.size() ? 1 : b1_.size() / b2_.size();
+            p_ = p_ > delta ? p_ - delta : 0;
+            b2_.erase(ghost->second.pos);
+        }
+        ghosts_.erase(ghost);
+
+        t2_.push_front(idx);
+        s.queue = Queue::T2;
+        s.pos = t2_.begin();
+    }
+    resident_[pid] = idx;
+
+    // the directory holds at most c pages in T1 + B1 and 2c in total
+    while (t1_.size() + b1_.size() > c_ && !b1_.empty()) {
+        drop_ghost_lru(Queue::B1);
+    }
+    while (t1_.size() + t2_.size() + b1_.size() + b2_.size() > 2 * c_) {
+        if (!b2_.empty()) {
+            drop_ghost_lru(Queue::B2);
+        } else if (!b1_.empty()) {
+            drop_ghost_lru(Queue::B1);
+        } else {
+            break;
+        }
+    }
+}
+
+void ARCPolicy::touch(size_t idx) {
+    ++now_;
+    Slot& s = slots_[idx];
+
+    if (s.queue == Queue::T2) {
+        t2_.splice(t2_.begin(), t2_, s.pos);
+    } else if (s.queue == Queue::T1) {
+        if (now_ - s.last > correlated_period_) {
+            // seen twice: promote to T2
+            t1_.erase(s.pos);
+            t2_.push_front(idx);
+            s.queue = Queue::T2;
+            s.pos = t2_.begin();
+        } else {
+            t1_.splice(t1_.begin(), t1_, s.pos);
+        }
+    }
+    s.last = now_;
+}
+
+void ARCPolicy::forget(size_t idx) {
+    // the page the frame held before was evicted: move it to the ghost
+    // list of its queue, unless it has been reloaded into another frame
+    Slot& s = slots_[idx];
+    if (s.queue == Queue::NONE) {
+        untracked_.erase(idx);
+        return;
+    }
+
+    bool was_t1 = s.queue == Queue::T1;
+    (was_t1 ? t1_ : t2_).erase(s.pos);
+    s.queue = Queue::NONE;
+
+    auto it = resident_.find(s.page_id);
+    if (it != resident_.end() && it->second == idx) {
+        resident_.erase(it);
+        add_ghost(was_t1 ? Queue::B1 : Queue::B2, s.page_id);
+    }
+}
+
+void ARCPolicy::add_ghost(Queue queue, page_id_t pid) {
+    auto& list = queue == Queue::B1 ? b1_ : b2_;
+    list.push_front(pid);
+    ghosts_[pid] = Ghost{queue, list.begin()};
+}
+
+void ARCPolicy::drop_ghost_lru(Queue queue) {
+    auto& list = queue == Queue::B1 ? b1_ : b2_;
+    ghosts_.erase(list.back());
+    list.pop_back();
+}
+
+Frame* ARCPolicy::lru_unpinned(const std::list<size_t>& queue) const {
+    for (auto it = queue.rbegin(); it != queue.rend(); ++it) {
+        Frame* f = frames_[*it];
+        if (f->pin_count == 0) return f;
+    }
+    return nullptr;
+}
+}
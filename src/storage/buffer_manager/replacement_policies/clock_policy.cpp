@@ -1,52 +1,83 @@
 #include "storage/buffer_manager/replacement_policies/clock_policy.h"
 
 namespace db::storage {
-ClockPolicy::ClockPolicy(std::vector<Frame*>& frames) : frames_{frames}, hand_{0} {
+ClockPolicy::ClockPolicy(std::vector<Frame*>& frames) : hand_{0}, frames_{frames} {
     N_ = frames.size();
-    ref_bits_.resize(N_, 0);
+    ref_bits_ = std::make_unique<std::atomic<uint8_t>[]>(N_);
     for (size_t i = 0; i < N_; ++i) {
+        ref_bits_[i] = 0;
         frame_idx_[frames[i]] = i;
     }
 }   
 
 Frame* ClockPolicy::choose_victim() {
     for (size_t scanned = 0; scanned < 2 * N_; ++scanned) {
-        Frame* f = frames_[hand_];
-        size_t idx = hand_;
+        size_t idx = hand_.load(std::memory_order_relaxed);
+        Frame* f = frames_[idx];
 
         // only consider unpinned
         if (f->pin_count == 0) {
-            if (ref_bits_[idx] == 0) {
+            if (ref_bits_[idx].load(std::memory_order_relaxed) == 0) {
                 return f;
             }
 
             // second chance, clear ref bit
-            ref_bits_[idx] = 0;
+            ref_bits_[idx].store(0, std::memory_order_relaxed);
         }
 
-        advance_hand();
+        // a concurrent sweep may have moved the hand already
+        hand_.compare_exchange_strong(idx, (idx + 1) % N_, std::memory_order_relaxed);
     }
 
     // throw error if can't find frame
     return nullptr;
 }
 
+void ClockPolicy::upcoming_victims(size_t n, std::vector<Frame*>& out) {
+    // one lap from the hand: frames with a clear reference bit go on
+    // this lap, the others only after their second chance
+    std::vector<Frame*> second_lap;
+    size_t start = hand_.load(std::memory_order_relaxed);
+    size_t taken = 0;
+    for (size_t i = 0; i < N_ && taken < n; ++i) {
+        size_t idx = (start + i) % N_;
+        Frame* f = frames_[idx];
+        if (f->pin_count != 0 || f->page_id == INVALID_PAGE_ID) continue;
+
+        if (ref_bits_[idx].load(std::memory_order_relaxed) == 0) {
+            out.push_back(f);
+            ++taken;
+        } else {
+            second_lap.push_back(f);
+        }
+    }
+    for (size_t i = 0; i < second_lap.size() && taken < n; ++i, ++taken) {
+        out.push_back(second_lap[i]);
+    }
+}
+
+bool ClockPolicy::referenced(Frame* f) {
+    return ref_bits_[frame_idx_.at(f)].load(std::memory_order_relaxed) != 0;
+}
+
 void ClockPolicy::advance_hand() {
-    hand_ = (hand_ + 1) % N_;
+    size_t idx = hand_.load(std::memory_order_relaxed);
+    while (!hand_.compare_exchange_weak(idx, (idx + 1) % N_, std::memory_order_relaxed)) {
+    }
 }
 
 void ClockPolicy::record_access(Frame* f) {
     // page HIT
     // recently accessed
-    size_t idx = frame_idx_[f];
-    ref_bits_[idx] = 1;
+    size_t idx = frame_idx_.at(f);
+    ref_bits_[idx].store(1, std::memory_order_relaxed);
 }
 
 void ClockPolicy::record_load(Frame* f) {
     // page LOAD into frame
     // most recently used
-    size_t idx = frame_idx_[f];
-    ref_bits_[idx] = 1;
+    size_t idx = frame_idx_.at(f);
+    ref_bits_[idx].store(1, std::memory_order_relaxed);
 
 }
 
@@ -54,7 +85,7 @@ void ClockPolicy::record_unpin(Frame* f) {
     // when the pin count drops to 0,
 	// page has recently been unpinned. 
     // try not to replace it immediately (i.e second chance)
-    size_t idx = frame_idx_[f];
-    ref_bits_[idx] = 0;
+    size_t idx = frame_idx_.at(f);
+    ref_bits_[idx].store(0, std::memory_order_relaxed);
+}
 }
-}
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "storage/buffer_manager/replacement_policies/lru_k_policy.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace db::storage {
+LRUKPolicy::LRUKPolicy(std::vector<Frame*>& frames)
+    : LRUKPolicy(frames, config::LRU_K, config::CORRELATED_REFERENCE_PERIOD,
+                 frames.size() * config::LRU_K_RETAINED_PERCENT / 100) {}
+
+LRUKPolicy::LRUKPolicy(std::vector<Frame*>& frames, size_t k,
+                       uint64_t correlated_period, size_t retained_pages)
+    : k_{k}, correlated_period_{correlated_period},
+      retained_pages_{retained_pages}, frames_{frames} {
+    if (k_ == 0) {
+        throw std::invalid_argument("LRUKPolicy: k must be at least 1");
+    }
+    slots_.resize(frames.size());
+    for (size_t i = 0; i < frames.size(); ++i) {
+        frame_idx_[frames[i]] = i;
+        untracked_.insert(i);
+    }
+}
+
+Frame* LRUKPolicy::choose_victim() {
+    std::lock_guard<std::mutex> lock{mu_};
+
+    for (size_t i : untracked_) {
+        if (frames_[i]->pin_count == 0) return frames_[i];
+    }
+
+    // pages still inside their correlated period go last
+    Frame* fallback = nullptr;
+    for (const auto& [kth, recent, i] : order_) {
+        Frame* f = frames_[i];
+        if (f->pin_count != 0) continue;
+        if (!correlated(i)) return f;
+        if (fallback == nullptr) fallback = f;
+    }
+    return fallback;
+}
+
+void LRUKPolicy::upcoming_victims(size_t n, std::vector<Frame*>& out) {
+    std::lock_guard<std::mutex> lock{mu_};
+
+    size_t taken = 0;
+    for (bool late : {false, true}) {
+        for (const auto& [kth, recent, i] : order_) {
+            if (taken == n) return;
+            if (frames_[i]->pin_count != 0 || correlated(i) != late) continue;
+            out.push_back(frames_[i]);
+            ++taken;
+        }
+    }
+}
+
+bool LRUKPolicy::referenced(Frame* f) {
+    std::lock_guard<std::mutex> lock{mu_};
+    const Slot& s = slots_[frame_idx_.at(f)];
+    return s.page_id == f->page_id && s.history.hist.size() == k_
+        && s.history.hist[k_ - 1] != 0;
+}
+
+void LRUKPolicy::record_access(Frame* f) {
+    // page HIT
+    std::lock_guard<std::mutex> lock{mu_};
+    size_t idx = frame_idx_.at(f);
+    page_id_t pid = f->page_id;
+
+    // a hit can be reported before the load of a frame that was just
+    // published by another thread
+    if (slots_[idx].page_id != pid) {
+        load(idx, pid);
+        return;
+    }
+    ++now_;
+    reference(idx);
+}
+
+void LRUKPolicy::record_load(Frame* f) {
+    // page LOAD into frame
+    std::lock_guard<std::mutex> lock{mu_};
+    size_t idx = frame_idx_.at(f);
+    page_id_t pid = f->page_id;
+
+    if (slots_[idx].page_id == pid) {
+        ++now_;
+        reference(idx);
+        return;
+    }
+    load(idx, pid);
+}
+
+void LRUKPolicy::record_unpin(Frame*) {
+    // LRU-K orders pages by reference times only
+}
+
+// private methods
+LRUKPolicy::Key LRUKPolicy::victim_key(size_t idx) const {
+    const History& h = slots_[idx].history;
+    return {h.hist[k_ - 1], h.hist[0], idx};
+}
+
+bool LRUKPolicy::correlated(size_t idx) const {
+    return now_ - slots_[idx].history.last <= correlated_period_;
+}
+
+void LRUKPolicy::reference(size_t idx) {
+    History& h = slots_[idx].history;
+    if (h.hist.empty()) {
+        // first reference ever seen
+        h.hist.assign(k_, 0);
+        h.hist[0] = now_;
+        h.last = now_;
+        order_.insert(victim_key(idx));
+        return;
+    }
+
+    if (now_ - h.last > correlated_period_) {
+        // uncorrelated: shift the history, moving the older references
+        // forward by the length of the correlated burst that just ended
+        order_.erase(victim_key(idx));
+        uint64_t burst = h.last - h.hist[0];
+        for (size_t i = k_ - 1; i > 0; --i) {
+            h.hist[i] = h.hist[i - 1] == 0 ? 0 : h.hist[i - 1] + burst;
+        }
+        h.hist[0] = now_;
+        order_.insert(victim_key(idx));
+    }
+    h.last = now_;
+}
+
+void LRUKPolicy::load(size_t idx, page_id_t pid) {
+    Slot& s = slots_[idx];
+    if (s.page_id == INVALID_PAGE_ID) {
+        untracked_.erase(idx);
+    } else {
+        order_.erase(victim_key(idx));
+    }
+
+    // remember the history of the page the frame held before. skip it if
+    // the page has been reloaded into another frame meanwhile.
+    if (s.page_id != INVALID_PAGE_ID) {
+        auto it = resident_.find(s.page_id);
+        if (it != resident_.end() && it->second == idx) {
+            resident_.erase(it);
+            retain(s.page_id, std::move(s.history));
+        }
+    }
+
+    s.page_id = pid;
+    s.history = {};
+    auto it = retained_.find(pid);
+    if (it != retained_.end()) {
+        s.history = std::move(it->second.history);
+        retained_.erase(it);
+    }
+    resident_[pid] = idx;
+
+    ++now_;
+    if (!s.history.hist.empty()) order_.insert(victim_key(idx));
+    reference(idx);
+}
+
+void LRUKPolicy::retain(page_id_t pid, History h) {
+    if (retained_pages_ == 0) return;
+
+    retained_[pid] = Retained{std::move(h), now_};
+    retained_order_.emplace_back(pid, now_);
+
+    // drop the oldest histories. entries for pages that were reloaded or
+    // evicted again since are stale and only need popping.
+    while (!retained_order_.empty()) {
+        auto [old_pid, evicted_at] = retained_order_.front();
+        auto it = retained_.find(old_pid);
+        bool stale = it == retained_.end() || it->second.evicted_at != evicted_at;
+        if (!stale && retained_order_.size() <= retained_pages_) break;
+
+        if (!stale) retained_.erase(it);
+        retained_order_.pop_front();
+    }
+}
+}
@@ -0,0 +1,155 @@
+#include "storage/buffer_manager/replacement_policies/two_q_policy.h"
+
+namespace db::storage {
+TwoQPolicy::TwoQPolicy(std::vector<Frame*>& frames)
+    : TwoQPolicy(frames,
+                 frames.size() * config::TWO_Q_KIN_PERCENT / 100,
+                 frames.size() * config::TWO_Q_KOUT_PERCENT / 100) {}
+
+TwoQPolicy::TwoQPolicy(std::vector<Frame*>& frames, size_t kin, size_t kout)
+    : kin_{kin}, kout_{kout}, frames_{frames} {
+    slots_.resize(frames.size());
+    for (size_t i = 0; i < frames.size(); ++i) {
+        frame_idx_[frames[i]] = i;
+        untracked_.insert(i);
+    }
+}
+
+Frame* TwoQPolicy::choose_victim() {
+    std::lock_guard<std::mutex> lock{mu_};
+
+    for (size_t i : untracked_) {
+        if (frames_[i]->pin_count == 0) return frames_[i];
+    }
+
+    // take from A1in while it is over its share, otherwise from Am.
+    // fall back to the other queue if everything there is pinned.
+    if (a1in_.size() > kin_) {
+        if (Frame* f = oldest_unpinned(a1in_)) return f;
+        return oldest_unpinned(am_);
+    }
+    if (Frame* f = oldest_unpinned(am_)) return f;
+    return oldest_unpinned(a1in_);
+}
+
+void TwoQPolicy::upcoming_victims(size_t n, std::vector<Frame*>& out) {
+    std::lock_guard<std::mutex> lock{mu_};
+
+    // replay choose_victim() against the current queues: take from
+    // A1in while it stays above kin, otherwise from Am
+    auto first = a1in_.rbegin();
+    auto second = am_.rbegin();
+    size_t first_left = a1in_.size();
+    size_t taken = 0;
+    while (taken < n && (first != a1in_.rend() || second != am_.rend())) {
+        bool from_first = second == am_.rend()
+            || (first != a1in_.rend() && first_left > kin_);
+        size_t idx = from_first ? *first++ : *second++;
+        if (from_first) --first_left;
+
+        Frame* f = frames_[idx];
+        if (f->pin_count != 0) continue;
+        out.push_back(f);
+        ++taken;
+    }
+}
+
+bool TwoQPolicy::referenced(Frame* f) {
+    std::lock_guard<std::mutex> lock{mu_};
+    const Slot& s = slots_[frame_idx_.at(f)];
+    return s.page_id == f->page_id && s.queue == Queue::AM;
+}
+
+void TwoQPolicy::record_access(Frame* f) {
+    // page HIT
+    std::lock_guard<std::mutex> lock{mu_};
+    size_t idx = frame_idx_.at(f);
+    page_id_t pid = f->page_id;
+
+    // a hit can be reported before the load of a frame that was just
+    // published by another thread
+    if (slots_[idx].page_id != pid) {
+        load(idx, pid);
+        return;
+    }
+    touch(idx);
+}
+
+void TwoQPolicy::record_load(Frame* f) {
+    // page LOAD into frame
+    std::lock_guard<std::mutex> lock{mu_};
+    size_t idx = frame_idx_.at(f);
+    page_id_t pid = f->page_id;
+
+    if (slots_[idx].page_id == pid) {
+        touch(idx);
+        return;
+    }
+    load(idx, pid);
+}
+
+void TwoQPolicy::record_unpin(Frame*) {
+    // 2Q orders pages by references only
+}
+
+// private methods
+void TwoQPolicy::load(size_t idx, page_id_t pid) {
+    Slot& s = slots_[idx];
+
+    // the page the frame held before was evicted
+    if (s.queue != Queue::NONE) {
+        bool was_a1in = s.queue == Queue::A1IN;
+        (was_a1in ? a1in_ : am_).erase(s.pos);
+        s.queue = Queue::NONE;
+
+        auto it = resident_.find(s.page_id);
+        if (it != resident_.end() && it->second == idx) {
+            resident_.erase(it);
+
+            // only pages evicted from A1in are remembered
+            if (was_a1in && kout_ > 0 && !a1out_idx_.contains(s.page_id)) {
+                a1out_.push_front(s.page_id);
+                a1out_idx_[s.page_id] = a1out_.begin();
+                if (a1out_.size() > kout_) {
+                    a1out_idx_.erase(a1out_.back());
+                    a1out_.pop_back();
+                }
+            }
+        }
+    } else {
+        untracked_.erase(idx);
+    }
+
+    s.page_id = pid;
+    auto ghost = a1out_idx_.find(pid);
+    if (ghost != a1out_idx_.end()) {
+        // second load within the A1out window: the page is hot
+        a1out_.erase(ghost->second);
+        a1out_idx_.erase(ghost);
+        am_.push_front(idx);
+        s.queue = Queue::AM;
+        s.pos = am_.begin();
+    } else {
+        a1in_.push_front(idx);
+        s.queue = Queue::A1IN;
+        s.pos = a1in_.begin();
+    }
+    resident_[pid] = idx;
+}
+
+void TwoQPolicy::touch(size_t idx) {
+    Slot& s = slots_[idx];
+    if (s.queue == Queue::AM) {
+        am_.splice(am_.begin(), am_, s.pos);
+    }
+    // hits in A1in are correlated references and leave the FIFO order
+}
+
+Frame* TwoQPolicy::oldest_unpinned(const std::list<size_t>& queue) const {
+    for (auto it = queue.rbegin(); it != queue.rend(); ++it) {
+        Frame* f = frames_[*it];
+        if (f->pin_count == 0) return f;
+    }
+    return nullptr;
+}
+}
@@ -0,0 +1,132 @@
+// replays a buffer pool trace recorded with BufferManager::start_trace()
+// against every replacement policy and a range of pool sizes, and prints
+// the hit ratio of each, one row per pool size.
+// usage: trace_replay <trace> [pool size...]
+// without pool sizes, powers of two from 16 frames up to the number of
+// distinct pages in the trace are tried.
+#include "storage/buffer_manager/buffer_manager.h"
+#include "storage/buffer_manager/buffer_trace.h"
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace db::storage;
+
+namespace {
+// pages are never looked at, so nothing is stored or read
+class NullDiskManager : public IDiskManager {
+public:
+    void ReadPage(page_id_t, char*) override {}
+    void WritePage(page_id_t, const char*) override {}
+    page_id_t AllocatePage() override { return 0; }
+    void DeallocatePage(page_id_t) override {}
+    void Sync() override {}
+};
+
+struct Replay {
+    double hit_ratio;
+    size_t skipped; // requests that found every frame pinned
+};
+
+Replay ReplayTrace(const std::string& path, ReplacementPolicyType type, size_t pool_size) {
+    NullDiskManager disk;
+    BufferManager bm{type, &disk, pool_size};
+    bm.set_verify_checksums(false);
+
+    // requests that could not be served are left out, and so are their
+    // releases. releases of pages requested before the trace started
+    // find nothing to release and are left out too.
+    std::unordered_map<page_id_t, size_t> skipped;
+    size_t total_skipped = 0;
+    TraceReader trace{path};
+    TraceRecord rec;
+    while (trace.next(rec)) {
+        if (rec.op == TraceOp::REQUEST) {
+            try {
+                bm.request(rec.page_id);
+            } catch (const std::runtime_error&) {
+                ++skipped[rec.page_id];
+                ++total_skipped;
+            }
+            continue;
+        }
+
+        auto it = skipped.find(rec.page_id);
+        if (it != skipped.end() && it->second > 0) {
+            --it->second;
+            continue;
+        }
+        try {
+            bm.release(rec.page_id);
+        } catch (const std::runtime_error&) {
+        }
+    }
+
+    BufferPoolStats s = bm.stats();
+    return {s.hit_ratio(), total_skipped};
+}
+
+size_t DistinctPages(const std::string& path) {
+    std::unordered_set<page_id_t> pages;
+    TraceReader trace{path};
+    TraceRecord rec;
+    while (trace.next(rec)) pages.insert(rec.page_id);
+    return pages.size();
+}
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <trace> [pool size...]\n";
+        return 2;
+    }
+    const std::string path = argv[1];
+
+    try {
+        size_t distinct = DistinctPages(path);
+        std::vector<size_t> sizes;
+        for (int i = 2; i < argc; ++i) {
+            sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+        }
+        if (sizes.empty()) {
+            for (size_t n = 16; n < distinct; n *= 2) sizes.push_back(n);
+            sizes.push_back(distinct > 0 ? distinct : 1);
+        }
+
+        struct Policy { const char* name; ReplacementPolicyType type; };
+        const Policy policies[] = {
+            {"CLOCK", ReplacementPolicyType::CLOCK},
+            {"LRU-2", ReplacementPolicyType::LRU_K},
+            {"2Q", ReplacementPolicyType::TWO_Q},
+            {"ARC", ReplacementPolicyType::ARC},
+        };
+
+        std::cout << path << ": " << distinct << " distinct pages\n"
+                  << std::setw(10) << "frames";
+        for (const auto& p : policies) std::cout << std::setw(9) << p.name;
+        std::cout << '\n';
+
+        for (size_t size : sizes) {
+            if (size == 0) continue;
+            std::cout << std::setw(10) << size;
+            size_t skipped = 0;
+            for (const auto& p : policies) {
+                Replay r = ReplayTrace(path, p.type, size);
+                skipped += r.skipped;
+                std::cout << std::fixed << std::setprecision(1)
+                          << std::setw(8) << r.hit_ratio * 100 << '%';
+            }
+            if (skipped > 0) std::cout << "  (" << skipped << " requests found every frame pinned)";
+            std::cout << '\n';
+        }
+    } catch (const std::exception& e) {
+        std::cerr << argv[0] << ": " << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
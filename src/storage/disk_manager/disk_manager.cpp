@@ -1,63 +1,870 @@
 #include "storage/disk_manager/disk_manager.h"
+#include "storage/disk_manager/lz_codec.h"
+#include "storage/page/page_checksum.h"
 #include "config/config.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
 
 namespace db::storage {
-DiskManager::DiskManager(const std::string &db_file) {
-    db_io_ = std::fstream(db_file, std::ios::in | std::ios::out | std::ios::binary);
-    if (!db_io_.is_open()) {
-        // create file if not exists
-        db_io_.open(db_file, std::ios::out | std::ios::binary);
-        db_io_.close();
-        db_io_.open(db_file, std::ios::in | std::ios::out | std::ios::binary);
+namespace {
+// O_DIRECT requires the buffer, offset and length to be aligned
+// to the logical block size of the device. 4 KB covers all common devices.
+constexpr size_t DIRECT_IO_ALIGNMENT = 4096;
+
+// upper bound on pages merged into one vectored I/O
+#ifdef IOV_MAX
+constexpr size_t MAX_IOV = IOV_MAX;
+#else
+constexpr size_t MAX_IOV = 1024;
+#endif
+
+// consecutive sequential (random) reads before mmap mode switches
+// the kernel readahead advice
+constexpr size_t SEQUENTIAL_THRESHOLD = 4;
+constexpr size_t RANDOM_THRESHOLD = 8;
+
+std::runtime_error IOError(const std::string& where) {
+    return std::runtime_error(where + ": " + std::strerror(errno));
+}
+
+bool IsAligned(const void* ptr) {
+    return reinterpret_cast<uintptr_t>(ptr) % DIRECT_IO_ALIGNMENT == 0;
+}
+
+// per-thread aligned scratch page used when a direct I/O caller
+// hands us an unaligned buffer.
+char* BouncePage() {
+    struct FreeDeleter { void operator()(char* p) const { std::free(p); } };
+    static thread_local std::unique_ptr<char, FreeDeleter> page{
+        static_cast<char*>(std::aligned_alloc(DIRECT_IO_ALIGNMENT,
+                                              config::PAGE_SIZE))
+    };
+    return page.get();
+}
+
+size_t MapPhysicalPage(size_t map_idx) {
+    return map_idx * (PAGES_PER_ALLOC_MAP + 1);
+}
+
+uint8_t* MapBits(char* map) {
+    return reinterpret_cast<uint8_t*>(map + sizeof(AllocMapHeader));
+}
+
+// whole-buffer pread/pwrite on a plain descriptor, used while migrating
+void ReadFully(int fd, size_t offset, char* buf, size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = ::pread(fd, buf + done, len - done, offset + done);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw IOError("DiskManager: migration read");
+        }
+        if (n == 0) break;
+        done += static_cast<size_t>(n);
+    }
+    std::memset(buf + done, 0, len - done);
+}
+
+void WriteFully(int fd, size_t offset, const char* buf, size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = ::pwrite(fd, buf + done, len - done, offset + done);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw IOError("DiskManager: migration write");
+        }
+        done += static_cast<size_t>(n);
+    }
+}
+
+bool IsCompressedPage(const char* page) {
+    const auto* hdr = reinterpret_cast<const CompressedPageHeader*>(page);
+    if (hdr->magic != config::COMPRESSED_PAGE_MAGIC) return false;
+    if (hdr->length > config::PAGE_SIZE - sizeof(CompressedPageHeader)) return false;
+    return hdr->checksum == Crc32c(page + sizeof(CompressedPageHeader), hdr->length);
+}
+}
+
+DiskManager::DiskManager(const std::string &db_file,
+                         DiskManagerOptions options) : options_{options} {
+    if (options_.use_mmap && options_.direct_io) {
+        throw std::invalid_argument(
+            "DiskManager: use_mmap cannot be combined with direct_io");
+    }
+    if (options_.use_mmap && options_.compress) {
+        throw std::invalid_argument(
+            "DiskManager: use_mmap cannot be combined with compress");
+    }
+
+    MigrateFlatFile(db_file);
+
+    int flags = O_RDWR | O_CREAT;
+#ifdef O_DIRECT
+    if (options_.direct_io) flags |= O_DIRECT;
+#endif
+    fd_ = ::open(db_file.c_str(), flags, 0644);
+    if (fd_ < 0) {
+        throw IOError("DiskManager: cannot open " + db_file);
+    }
+#ifdef F_NOCACHE
+    if (options_.direct_io) ::fcntl(fd_, F_NOCACHE, 1);
+#endif
+
+    struct stat st;
+    if (::fstat(fd_, &st) == 0) {
+        phys_pages_ = static_cast<size_t>(st.st_size) / db::config::PAGE_SIZE;
     }
 
-    next_page_id_ = GetNumPages();
+    LoadAllocMaps();
+
+    if (options_.use_mmap) {
+        MapFile(options_.mmap_reserve);
+    }
 };
 
 DiskManager::~DiskManager() {
-    db_io_.close();
+    // queued reads complete first
+    {
+        std::lock_guard<std::mutex> lock{read_mu_};
+        stopping_ = true;
+    }
+    read_cv_.notify_all();
+    if (reader_.joinable()) reader_.join();
+
+    try {
+        WriteDirtyAllocMaps();
+    } catch (...) {
+        // nothing sensible to do in a destructor; the maps are lost
+    }
+
+    if (map_ != nullptr) ::munmap(map_, map_len_);
+    for (auto& [addr, len] : retired_maps_) {
+        ::munmap(addr, len);
+    }
+    ::close(fd_);
 };
 
 void DiskManager::ReadPage(page_id_t page_id, char* page_data) {
-    db_io_.clear();
-    const size_t offset = static_cast<size_t>(page_id) * db::config::PAGE_SIZE;
-    db_io_.seekg(offset);
-    db_io_.read(page_data, db::config::PAGE_SIZE);
+    if (options_.use_mmap) {
+        const char* src;
+        {
+            std::lock_guard<std::mutex> lock{map_mu_};
+            src = MappedPage(page_id);
+            AdviseAccess(page_id);
+        }
+
+        // retired mappings stay valid, so the copy needs no latch
+        if (src == nullptr) {
+            std::memset(page_data, 0, db::config::PAGE_SIZE);
+        } else {
+            std::memcpy(page_data, src, db::config::PAGE_SIZE);
+        }
+        return;
+    }
+
+    if (options_.compress) {
+        ReadCompressed(PhysicalPage(page_id), page_data);
+        return;
+    }
+    ReadPhysical(PhysicalPage(page_id), page_data);
 }
 
 void DiskManager::WritePage(page_id_t page_id, const char* page_data) {
-    db_io_.clear();
-    const size_t offset = static_cast<size_t>(page_id) * db::config::PAGE_SIZE;
-    db_io_.seekp(offset);
-    db_io_.write(page_data, db::config::PAGE_SIZE);
-    db_io_.flush();
+    PersistAllocations({&page_id, 1});
+    if (options_.compress) {
+        WriteCompressed(PhysicalPage(page_id), page_data);
+        return;
+    }
+    WritePhysical(PhysicalPage(page_id), page_data);
+}
+
+void DiskManager::ReadPages(std::span<const page_id_t> page_ids,
+                            std::span<char* const> pages) {
+    if (options_.use_mmap || options_.compress) {
+        for (size_t i = 0; i < page_ids.size(); ++i) {
+            ReadPage(page_ids[i], pages[i]);
+        }
+        return;
+    }
+    TransferPages(false, page_ids, pages.data());
+}
+
+void DiskManager::WritePages(std::span<const page_id_t> page_ids,
+                             std::span<const char* const> pages) {
+    PersistAllocations(page_ids);
+    if (options_.compress) {
+        // compressed pages have variable length; no vectored write
+        for (size_t i = 0; i < page_ids.size(); ++i) {
+            WritePage(page_ids[i], pages[i]);
+        }
+        return;
+    }
+    TransferPages(true, page_ids, pages.data());
+}
+
+std::future<void> DiskManager::ReadPageAsync(page_id_t page_id, char* page_data) {
+    auto done = std::make_shared<std::promise<void>>();
+    auto fut = done->get_future();
+    ReadPageAsync(page_id, page_data, [done](std::exception_ptr err) {
+        if (err) done->set_exception(err);
+        else done->set_value();
+    });
+    return fut;
+}
+
+void DiskManager::ReadPageAsync(page_id_t page_id, char* page_data,
+                                IOCallback on_complete) {
+    {
+        std::lock_guard<std::mutex> lock{read_mu_};
+        pending_reads_.push_back({page_id, page_data, std::move(on_complete)});
+        if (!reader_.joinable()) reader_ = std::thread{&DiskManager::ReadLoop, this};
+    }
+    read_cv_.notify_one();
 }
 
 db::storage::page_id_t DiskManager::AllocatePage() {
+    std::lock_guard<std::mutex> lock{alloc_mu_};
+    page_id_t id;
     if (!free_list.empty()) {
         // free list available
         // use a current free frame instead of adding to free list
-        auto id = free_list.back();
+        id = free_list.back();
         free_list.pop_back();
-        return id;
+    } else {
+        // free list empty: all existing page used
+        // append a new one
+        id = next_page_id_++;
+    }
+
+    SetAllocated(id, true);
+    return id;
+}
+
+page_id_t DiskManager::AllocateFilePage(const config::uuid_t& file_id) {
+    std::lock_guard<std::mutex> lock{alloc_mu_};
+    auto it = extents_.find(file_id);
+    if (it == extents_.end() || it->second.next >= it->second.end) {
+        size_t size = (it == extents_.end())
+            ? db::config::EXTENT_MIN_PAGES
+            : std::min(it->second.size * 2, db::config::EXTENT_MAX_PAGES);
+        auto [start, len] = ReuseFreeRun(size);
+        if (len == 0) {
+            start = ReserveExtent(size);
+            len = size;
+        }
+        it = extents_.insert_or_assign(file_id, Extent{
+            start, start + static_cast<page_id_t>(len), size}).first;
     }
-    
-    // free list empty: all existing page used
-    // append a new one
-    return next_page_id_++;
+
+    page_id_t id = it->second.next++;
+    SetAllocated(id, true);
+    return id;
 }
 
 void DiskManager::DeallocatePage(page_id_t page_id) {
+    std::lock_guard<std::mutex> lock{alloc_mu_};
+    // ignore double frees so a page is never handed out twice
+    if (!IsAllocated(page_id)) return;
+
+    SetAllocated(page_id, false);
     free_list.push_back(page_id);
 }
 
+void DiskManager::Sync() {
+    // allocations wait for the sync, so none is counted durable before
+    // its map bit is
+    std::lock_guard<std::mutex> lock{alloc_mu_};
+    WriteDirtyAllocMaps();
+    SyncFile();
+    unsynced_allocs_.clear();
+    unsynced_count_ = 0;
+}
+
 int DiskManager::GetNumPages() const {
-    db_io_.clear();
-    db_io_.seekg(0, std::ios::end);
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) return 0;
+    size_t phys = static_cast<size_t>(st.st_size) / db::config::PAGE_SIZE;
+
+    // every run of PAGES_PER_ALLOC_MAP + 1 physical pages starts with a map
+    size_t maps = (phys + PAGES_PER_ALLOC_MAP) / (PAGES_PER_ALLOC_MAP + 1);
+    return static_cast<int>(phys - maps);
+}
+
+const char* DiskManager::PageData(page_id_t page_id) {
+    if (!options_.use_mmap) {
+        throw std::runtime_error("DiskManager::PageData(): mmap mode is not enabled");
+    }
+
+    std::lock_guard<std::mutex> lock{map_mu_};
+    return MappedPage(page_id);
+}
+
+// private helpers
+const char* DiskManager::MappedPage(page_id_t page_id) {
+    // touching the mapping past end of file raises SIGBUS
+    if (page_id < 0) return nullptr;
+    size_t phys = PhysicalPage(page_id);
+    if (phys >= phys_pages_) return nullptr;
+
+    size_t end = (phys + 1) * db::config::PAGE_SIZE;
+    if (end > map_len_) {
+        MapFile(std::max(end, map_len_ * 2));
+    }
+    return map_ + phys * db::config::PAGE_SIZE;
+}
+
+size_t DiskManager::PhysicalPage(page_id_t page_id) {
+    size_t logical = static_cast<size_t>(page_id);
+    return logical + logical / PAGES_PER_ALLOC_MAP + 1;
+}
+
+void DiskManager::MigrateFlatFile(const std::string& db_file) {
+    constexpr size_t PAGE = db::config::PAGE_SIZE;
+
+    int in = ::open(db_file.c_str(), O_RDONLY);
+    if (in < 0) return; // a new database
+    struct stat st;
+    if (::fstat(in, &st) != 0 || static_cast<size_t>(st.st_size) < PAGE) {
+        ::close(in);
+        return;
+    }
+
+    // format 1 stored the catalog's DBHeaderPage at physical page 0,
+    // where format 2 has allocation map 0
+    auto page = std::make_unique<char[]>(PAGE);
+    try {
+        ReadFully(in, 0, page.get(), PAGE);
+    } catch (...) {
+        ::close(in);
+        throw;
+    }
+    if (reinterpret_cast<const DBHeaderPage*>(page.get())->magic != config::DB_MAGIC) {
+        ::close(in);
+        return;
+    }
+
+    // the copy is built next to the file and renamed over it, so a crash
+    // leaves either the old file or the complete new one
+    const std::string tmp = db_file + ".migrate";
+    int out = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) {
+        ::close(in);
+        throw IOError("DiskManager: cannot create " + tmp);
+    }
+    try {
+        // format 1 kept its free list in memory only, so every stored
+        // page counts as allocated
+        const size_t pages = static_cast<size_t>(st.st_size) / PAGE;
+        for (size_t k = 0; k * PAGES_PER_ALLOC_MAP < pages; ++k) {
+            std::memset(page.get(), 0, PAGE);
+            auto* hdr = reinterpret_cast<AllocMapHeader*>(page.get());
+            hdr->magic = config::ALLOC_MAP_MAGIC;
+            hdr->version = config::DISK_FORMAT_VERSION;
+            size_t covered = std::min(PAGES_PER_ALLOC_MAP, pages - k * PAGES_PER_ALLOC_MAP);
+            uint8_t* bits = MapBits(page.get());
+            for (size_t b = 0; b < covered; ++b) {
+                bits[b / 8] |= static_cast<uint8_t>(1u << (b % 8));
+            }
+            WriteFully(out, MapPhysicalPage(k) * PAGE, page.get(), PAGE);
+        }
+        for (size_t i = 0; i < pages; ++i) {
+            ReadFully(in, i * PAGE, page.get(), PAGE);
+            WriteFully(out, PhysicalPage(static_cast<page_id_t>(i)) * PAGE, page.get(), PAGE);
+        }
+        if (::fsync(out) != 0) throw IOError("DiskManager: migration sync");
+    } catch (...) {
+        ::close(in);
+        ::close(out);
+        ::unlink(tmp.c_str());
+        throw;
+    }
+    ::close(in);
+    ::close(out);
+
+    if (::rename(tmp.c_str(), db_file.c_str()) != 0) {
+        ::unlink(tmp.c_str());
+        throw IOError("DiskManager: cannot replace " + db_file);
+    }
+    // make the rename itself durable
+    std::string dir = std::filesystem::path(db_file).parent_path().string();
+    int dfd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY);
+    if (dfd >= 0) {
+        ::fsync(dfd);
+        ::close(dfd);
+    }
+}
+
+void DiskManager::ReadPhysical(size_t phys, char* buf) {
+    const size_t offset = phys * db::config::PAGE_SIZE;
+    if (options_.direct_io && !IsAligned(buf)) {
+        char* bounce = BouncePage();
+        ReadAt(offset, bounce, db::config::PAGE_SIZE);
+        std::memcpy(buf, bounce, db::config::PAGE_SIZE);
+        return;
+    }
+    ReadAt(offset, buf, db::config::PAGE_SIZE);
+}
+
+void DiskManager::WritePhysical(size_t phys, const char* buf) {
+    const size_t offset = phys * db::config::PAGE_SIZE;
+    if (options_.direct_io && !IsAligned(buf)) {
+        char* bounce = BouncePage();
+        std::memcpy(bounce, buf, db::config::PAGE_SIZE);
+        WriteAt(offset, bounce, db::config::PAGE_SIZE);
+    } else {
+        WriteAt(offset, buf, db::config::PAGE_SIZE);
+    }
+    GrowPhysPages(phys + 1);
+}
+
+void DiskManager::ReadCompressed(size_t phys, char* buf) {
+    // reading the punched-out part of a slot costs no disk I/O
+    char* in = BouncePage();
+    ReadPhysical(phys, in);
+
+    if (!IsCompressedPage(in)) {
+        std::memcpy(buf, in, db::config::PAGE_SIZE);
+        return;
+    }
+
+    const auto* hdr = reinterpret_cast<const CompressedPageHeader*>(in);
+    if (!LZDecompress(in + sizeof(CompressedPageHeader), hdr->length,
+                      buf, db::config::PAGE_SIZE)) {
+        throw std::runtime_error("DiskManager::ReadPage(): corrupt compressed page at physical page "
+                                 + std::to_string(phys));
+    }
+}
+
+void DiskManager::WriteCompressed(size_t phys, const char* buf) {
+    constexpr size_t BLOCK = db::config::COMPRESSION_BLOCK_SIZE;
+    constexpr size_t HEADER = sizeof(CompressedPageHeader);
+
+    // only worth it if at least one block of the slot is saved
+    char* out = BouncePage();
+    size_t len = LZCompress(buf, db::config::PAGE_SIZE, out + HEADER,
+                            db::config::PAGE_SIZE - BLOCK - HEADER);
+    if (len == 0) {
+        WritePhysical(phys, buf);
+        return;
+    }
+
+    auto* hdr = reinterpret_cast<CompressedPageHeader*>(out);
+    hdr->magic = config::COMPRESSED_PAGE_MAGIC;
+    hdr->length = static_cast<uint16_t>(len);
+    hdr->reserved = 0;
+    hdr->checksum = Crc32c(out + HEADER, len);
+
+    size_t stored = (HEADER + len + BLOCK - 1) / BLOCK * BLOCK;
+    std::memset(out + HEADER + len, 0, stored - HEADER - len);
+
+    const size_t offset = phys * db::config::PAGE_SIZE;
+    WriteAt(offset, out, stored);
+
+    // a page past end of file still has to extend the file to a whole
+    // slot; write its last block so the size never shrinks under a
+    // concurrent writer, then punch it out with the rest of the slot
+    if (phys >= phys_pages_) {
+        alignas(4096) static const char zeroes[BLOCK]{};
+        WriteAt(offset + db::config::PAGE_SIZE - BLOCK, zeroes, BLOCK);
+    }
+#ifdef FALLOC_FL_PUNCH_HOLE
+    // without hole punching the stale tail is simply ignored on read
+    ::fallocate(fd_, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                offset + stored, db::config::PAGE_SIZE - stored);
+#endif
+    GrowPhysPages(phys + 1);
+}
+
+void DiskManager::LoadAllocMaps() {
+    size_t num_maps = (phys_pages_ + PAGES_PER_ALLOC_MAP) / (PAGES_PER_ALLOC_MAP + 1);
+    page_id_t highest_allocated = -1;
+
+    for (size_t k = 0; k < num_maps; ++k) {
+        auto map = std::make_unique<char[]>(db::config::PAGE_SIZE);
+        ReadPhysical(MapPhysicalPage(k), map.get());
+
+        auto* hdr = reinterpret_cast<AllocMapHeader*>(map.get());
+        if (hdr->magic != config::ALLOC_MAP_MAGIC) {
+            bool blank = std::all_of(map.get(), map.get() + db::config::PAGE_SIZE,
+                                     [](char c) { return c == 0; });
+            if (!blank) {
+                throw std::runtime_error(
+                    "DiskManager: physical page " +
+                    std::to_string(MapPhysicalPage(k)) +
+                    " is not an allocation map; not a database file");
+            }
+            hdr->magic = config::ALLOC_MAP_MAGIC;
+            hdr->version = config::DISK_FORMAT_VERSION;
+        }
+        if (hdr->version != config::DISK_FORMAT_VERSION) {
+            throw std::runtime_error(
+                "DiskManager: allocation map " + std::to_string(k) +
+                " has disk format version " + std::to_string(hdr->version) +
+                ", expected " + std::to_string(config::DISK_FORMAT_VERSION));
+        }
+
+        const uint8_t* bits = MapBits(map.get());
+        for (size_t b = 0; b < PAGES_PER_ALLOC_MAP; ++b) {
+            if (bits[b / 8] & (1u << (b % 8))) {
+                highest_allocated = static_cast<page_id_t>(k * PAGES_PER_ALLOC_MAP + b);
+            }
+        }
+
+        alloc_maps_.push_back(std::move(map));
+        alloc_map_dirty_.push_back(false);
+    }
+
+    // pages allocated but never written lie past end of file
+    next_page_id_ = std::max(GetNumPages(), highest_allocated + 1);
+
+    // every unallocated page below the high-water mark is reusable.
+    // push in descending order so the lowest ids are handed out first.
+    for (page_id_t id = next_page_id_ - 1; id >= 0; --id) {
+        if (!IsAllocated(id)) free_list.push_back(id);
+    }
+}
+
+void DiskManager::SetAllocated(page_id_t page_id, bool allocated) {
+    size_t k = static_cast<size_t>(page_id) / PAGES_PER_ALLOC_MAP;
+    size_t b = static_cast<size_t>(page_id) % PAGES_PER_ALLOC_MAP;
+
+    while (alloc_maps_.size() <= k) {
+        auto map = std::make_unique<char[]>(db::config::PAGE_SIZE);
+        auto* hdr = reinterpret_cast<AllocMapHeader*>(map.get());
+        hdr->magic = config::ALLOC_MAP_MAGIC;
+        hdr->version = config::DISK_FORMAT_VERSION;
+        alloc_maps_.push_back(std::move(map));
+        alloc_map_dirty_.push_back(true);
+    }
+
+    uint8_t* bits = MapBits(alloc_maps_[k].get());
+    if (allocated) bits[b / 8] |= static_cast<uint8_t>(1u << (b % 8));
+    else bits[b / 8] &= static_cast<uint8_t>(~(1u << (b % 8)));
+    alloc_map_dirty_[k] = true;
+
+    // a free that is lost in a crash only leaks the page until it is
+    // freed again; a lost allocation would hand the page out twice
+    if (allocated) unsynced_allocs_.insert(page_id);
+    else unsynced_allocs_.erase(page_id);
+    unsynced_count_ = unsynced_allocs_.size();
+}
+
+bool DiskManager::IsAllocated(page_id_t page_id) const {
+    if (page_id < 0) return false;
+    size_t k = static_cast<size_t>(page_id) / PAGES_PER_ALLOC_MAP;
+    size_t b = static_cast<size_t>(page_id) % PAGES_PER_ALLOC_MAP;
+    if (k >= alloc_maps_.size()) return false;
+
+    const uint8_t* bits = MapBits(alloc_maps_[k].get());
+    return bits[b / 8] & (1u << (b % 8));
+}
+
+void DiskManager::WriteDirtyAllocMaps() {
+    for (size_t k = 0; k < alloc_maps_.size(); ++k) {
+        if (!alloc_map_dirty_[k]) continue;
+        WritePhysical(MapPhysicalPage(k), alloc_maps_[k].get());
+        alloc_map_dirty_[k] = false;
+    }
+}
+
+void DiskManager::PersistAllocations(std::span<const page_id_t> page_ids) {
+    if (unsynced_count_.load(std::memory_order_relaxed) == 0) return;
+
+    std::lock_guard<std::mutex> lock{alloc_mu_};
+    bool unsynced = std::any_of(page_ids.begin(), page_ids.end(), [this](page_id_t id) {
+        return unsynced_allocs_.contains(id);
+    });
+    if (!unsynced) return;
+
+    // otherwise the page could reach the disk while its map still says
+    // free, and be allocated again over live data after a crash
+    WriteDirtyAllocMaps();
+    SyncFile();
+    unsynced_allocs_.clear();
+    unsynced_count_ = 0;
+}
+
+void DiskManager::SyncFile() {
+#if defined(__APPLE__)
+    int rc = ::fsync(fd_);
+#else
+    int rc = ::fdatasync(fd_);
+#endif
+    if (rc != 0) {
+        throw IOError("DiskManager::Sync()");
+    }
+}
+
+void DiskManager::ReadLoop() {
+    std::vector<PendingRead> batch;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock{read_mu_};
+            read_cv_.wait(lock, [this] { return stopping_ || !pending_reads_.empty(); });
+            if (pending_reads_.empty()) return;
+            batch.swap(pending_reads_);
+        }
+
+        std::vector<page_id_t> ids;
+        std::vector<char*> pages;
+        for (const PendingRead& r : batch) {
+            ids.push_back(r.page_id);
+            pages.push_back(r.data);
+        }
+        std::exception_ptr err;
+        try {
+            ReadPages(ids, pages);
+        } catch (...) {
+            err = std::current_exception();
+        }
+
+        for (PendingRead& r : batch) {
+            std::exception_ptr page_err;
+            if (err) {
+                // find the page that failed; the others still succeed
+                try {
+                    ReadPage(r.page_id, r.data);
+                } catch (...) {
+                    page_err = std::current_exception();
+                }
+            }
+            r.on_complete(page_err);
+        }
+        batch.clear();
+    }
+}
+
+void DiskManager::GrowPhysPages(size_t n) {
+    size_t cur = phys_pages_.load();
+    while (cur < n && !phys_pages_.compare_exchange_weak(cur, n)) {
+    }
+}
+
+std::pair<page_id_t, size_t> DiskManager::ReuseFreeRun(size_t n) {
+    if (free_list.size() < db::config::EXTENT_MIN_PAGES) return {0, 0};
+
+    // in a sorted list, a run of consecutive ids is a contiguous range.
+    // descending, so AllocatePage() still pops the lowest ids first.
+    std::sort(free_list.begin(), free_list.end(), std::greater<>{});
+    size_t best = 0, best_len = 0;
+    for (size_t i = 0; i < free_list.size();) {
+        size_t j = i + 1;
+        while (j < free_list.size() && free_list[j] == free_list[j - 1] - 1) ++j;
+        if (j - i >= n) {
+            // the lowest n ids of the run
+            best = j - n;
+            best_len = n;
+            break;
+        }
+        if (j - i > best_len) {
+            best = i;
+            best_len = j - i;
+        }
+        i = j;
+    }
+    if (best_len < db::config::EXTENT_MIN_PAGES) return {0, 0};
+
+    page_id_t start = free_list[best + best_len - 1];
+    free_list.erase(free_list.begin() + static_cast<ptrdiff_t>(best),
+                    free_list.begin() + static_cast<ptrdiff_t>(best + best_len));
+    return {start, best_len};
+}
+
+page_id_t DiskManager::ReserveExtent(size_t n) {
+    page_id_t start = next_page_id_;
+    next_page_id_ += static_cast<page_id_t>(n);
+
+#ifdef __linux__
+    // preallocate the blocks so the extent is contiguous on disk and later
+    // writes into it do not extend the file one page at a time.
+    // filesystems without fallocate support simply grow on write.
+    size_t phys_start = PhysicalPage(start);
+    size_t phys_end = PhysicalPage(next_page_id_ - 1) + 1;
+    if (::fallocate(fd_, 0, phys_start * db::config::PAGE_SIZE,
+                    (phys_end - phys_start) * db::config::PAGE_SIZE) == 0) {
+        GrowPhysPages(phys_end);
+    }
+#endif
+    return start;
+}
+
+void DiskManager::MapFile(size_t min_len) {
+    size_t len = std::max(min_len, db::config::PAGE_SIZE);
+    void* addr = ::mmap(nullptr, len, PROT_READ, MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) {
+        throw IOError("DiskManager: mmap failed");
+    }
+
+    // keep the old region mapped so outstanding PageData() pointers stay valid
+    if (map_ != nullptr) retired_maps_.emplace_back(map_, map_len_);
+    map_ = static_cast<char*>(addr);
+    map_len_ = len;
+    advice_ = MADV_NORMAL;
+}
+
+void DiskManager::AdviseAccess(page_id_t page_id) {
+    if (page_id == last_read_ + 1) {
+        ++seq_run_;
+        random_run_ = 0;
+    } else {
+        seq_run_ = 0;
+        ++random_run_;
+    }
+    last_read_ = page_id;
+
+    if (seq_run_ >= SEQUENTIAL_THRESHOLD) {
+        // scan detected: let the kernel read ahead aggressively and
+        // drop pages behind us, and prefetch the next window explicitly
+        if (advice_ != MADV_SEQUENTIAL) {
+            ::madvise(map_, map_len_, MADV_SEQUENTIAL);
+            advice_ = MADV_SEQUENTIAL;
+        }
+        if (page_id + 1 >= readahead_end_) {
+            page_id_t start = page_id + 1;
+            page_id_t end = start + static_cast<page_id_t>(db::config::MMAP_READAHEAD_PAGES);
+            size_t phys_start = PhysicalPage(start);
+            size_t phys_end = std::min(PhysicalPage(end), phys_pages_.load());
+            if (phys_start < phys_end && phys_end * db::config::PAGE_SIZE <= map_len_) {
+                ::madvise(map_ + phys_start * db::config::PAGE_SIZE,
+                          (phys_end - phys_start) * db::config::PAGE_SIZE,
+                          MADV_WILLNEED);
+            }
+            readahead_end_ = end;
+        }
+    } else if (random_run_ >= RANDOM_THRESHOLD && advice_ != MADV_RANDOM) {
+        // point lookups: kernel readahead would only waste I/O
+        ::madvise(map_, map_len_, MADV_RANDOM);
+        advice_ = MADV_RANDOM;
+    }
+}
+
+void DiskManager::ReadAt(size_t offset, char* buf, size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = ::pread(fd_, buf + done, len - done, offset + done);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw IOError("DiskManager::ReadPage()");
+        }
+        if (n == 0) break; // end of file
+        done += static_cast<size_t>(n);
+    }
+
+    // page was allocated but never written
+    if (done < len) {
+        std::memset(buf + done, 0, len - done);
+    }
+}
 
-    std::streampos end = db_io_.tellg();
-    if (end < 0) return 0; 
+void DiskManager::WriteAt(size_t offset, const char* buf, size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = ::pwrite(fd_, buf + done, len - done, offset + done);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw IOError("DiskManager::WritePage()");
+        }
+        done += static_cast<size_t>(n);
+    }
+}
+
+void DiskManager::TransferPages(bool write,
+                                std::span<const page_id_t> page_ids,
+                                const char* const* pages) {
+    const size_t n = page_ids.size();
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return page_ids[a] < page_ids[b];
+    });
+
+    std::vector<iovec> iov;
+    iov.reserve(std::min(n, MAX_IOV));
+
+    size_t i = 0;
+    while (i < n) {
+        // extend the run while pages stay physically adjacent.
+        // logically adjacent pages are split by an allocation map
+        // once every PAGES_PER_ALLOC_MAP pages.
+        size_t j = i + 1;
+        while (j < n && j - i < MAX_IOV &&
+               PhysicalPage(page_ids[order[j]]) ==
+                   PhysicalPage(page_ids[order[j - 1]]) + 1) {
+            ++j;
+        }
+
+        bool aligned = true;
+        iov.clear();
+        for (size_t k = i; k < j; ++k) {
+            char* buf = const_cast<char*>(pages[order[k]]);
+            aligned = aligned && IsAligned(buf);
+            iov.push_back(iovec{buf, db::config::PAGE_SIZE});
+        }
 
-    return static_cast<int>(end / db::config::PAGE_SIZE);
+        // direct I/O cannot use unaligned buffers; take the bounce path
+        if (options_.direct_io && !aligned) {
+            for (size_t k = i; k < j; ++k) {
+                char* buf = const_cast<char*>(pages[order[k]]);
+                if (write) WritePage(page_ids[order[k]], buf);
+                else ReadPage(page_ids[order[k]], buf);
+            }
+            i = j;
+            continue;
+        }
+
+        size_t first_phys = PhysicalPage(page_ids[order[i]]);
+        size_t offset = first_phys * db::config::PAGE_SIZE;
+        size_t idx = 0;
+        while (idx < iov.size()) {
+            int cnt = static_cast<int>(iov.size() - idx);
+            ssize_t got = write ? ::pwritev(fd_, &iov[idx], cnt, offset)
+                                : ::preadv(fd_, &iov[idx], cnt, offset);
+            if (got < 0) {
+                if (errno == EINTR) continue;
+                throw IOError(write ? "DiskManager::WritePages()"
+                                    : "DiskManager::ReadPages()");
+            }
+
+            if (got == 0 && !write) {
+                // end of file: remaining pages were never written
+                for (; idx < iov.size(); ++idx) {
+                    std::memset(iov[idx].iov_base, 0, iov[idx].iov_len);
+                }
+                break;
+            }
+
+            // advance past fully transferred buffers, trim a partial one
+            size_t left = static_cast<size_t>(got);
+            offset += left;
+            while (left > 0) {
+                if (left >= iov[idx].iov_len) {
+                    left -= iov[idx].iov_len;
+                    ++idx;
+                } else {
+                    iov[idx].iov_base = static_cast<char*>(iov[idx].iov_base) + left;
+                    iov[idx].iov_len -= left;
+                    left = 0;
+                }
+            }
+        }
+
+        if (write) {
+            GrowPhysPages(first_phys + (j - i));
+        }
+        i = j;
+    }
 }
 }
@@ -0,0 +1,148 @@
+#include "storage/disk_manager/lz_codec.h"
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace db::storage {
+namespace {
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t MAX_OFFSET = 65535;
+constexpr int HASH_BITS = 12;
+
+uint32_t Load32(const unsigned char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+uint32_t Hash(uint32_t v) {
+    return (v * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// appends the continuation bytes of a length that overflowed its nibble
+bool PutLength(unsigned char*& op, const unsigned char* end, size_t len) {
+    for (; len >= 255; len -= 255) {
+        if (op >= end) return false;
+        *op++ = 255;
+    }
+    if (op >= end) return false;
+    *op++ = static_cast<unsigned char>(len);
+    return true;
+}
+
+bool GetLength(const unsigned char*& ip, const unsigned char* end, size_t& len) {
+    unsigned char b;
+    do {
+        if (ip >= end) return false;
+        b = *ip++;
+        len += b;
+    } while (b == 255);
+    return true;
+}
+
+bool PutSequence(unsigned char*& op, const unsigned char* end,
+                 const unsigned char* literals, size_t lit_len,
+                 size_t offset, size_t match_len) {
+    if (op >= end) return false;
+    unsigned char* token = op++;
+    size_t lit_nibble = lit_len < 15 ? lit_len : 15;
+    *token = static_cast<unsigned char>(lit_nibble << 4);
+    if (lit_len >= 15 && !PutLength(op, end, lit_len - 15)) return false;
+
+    if (static_cast<size_t>(end - op) < lit_len) return false;
+    std::memcpy(op, literals, lit_len);
+    op += lit_len;
+
+    if (match_len == 0) return true; // last sequence
+
+    if (end - op < 2) return false;
+    *op++ = static_cast<unsigned char>(offset & 0xFF);
+    *op++ = static_cast<unsigned char>(offset >> 8);
+
+    size_t m = match_len - MIN_MATCH;
+    *token |= static_cast<unsigned char>(m < 15 ? m : 15);
+    if (m >= 15 && !PutLength(op, end, m - 15)) return false;
+    return true;
+}
+}
+
+size_t LZCompress(const char* src, size_t len, char* dst, size_t capacity) {
+    const auto* in = reinterpret_cast<const unsigned char*>(src);
+    auto* op = reinterpret_cast<unsigned char*>(dst);
+    const unsigned char* out_end = op + capacity;
+
+    std::array<int32_t, size_t{1} << HASH_BITS> table;
+    table.fill(-1);
+
+    size_t anchor = 0;
+    size_t i = 0;
+    while (len >= MIN_MATCH && i + MIN_MATCH <= len) {
+        uint32_t seq = Load32(in + i);
+        uint32_t h = Hash(seq);
+        int32_t cand = table[h];
+        table[h] = static_cast<int32_t>(i);
+
+        if (cand < 0 || i - cand > MAX_OFFSET || Load32(in + cand) != seq) {
+            ++i;
+            continue;
+        }
+
+        size_t match = MIN_MATCH;
+        while (i + match < len && in[cand + match] == in[i + match]) ++match;
+
+        if (!PutSequence(op, out_end, in + anchor, i - anchor, i - cand, match)) {
+            return 0;
+        }
+        i += match;
+        anchor = i;
+    }
+
+    if (!PutSequence(op, out_end, in + anchor, len - anchor, 0, 0)) return 0;
+    return static_cast<size_t>(op - reinterpret_cast<unsigned char*>(dst));
+}
+
+bool LZDecompress(const char* src, size_t len, char* dst, size_t dst_len) {
+    const auto* ip = reinterpret_cast<const unsigned char*>(src);
+    const unsigned char* in_end = ip + len;
+    auto* base = reinterpret_cast<unsigned char*>(dst);
+    unsigned char* op = base;
+    const unsigned char* out_end = base + dst_len;
+
+    while (ip < in_end) {
+        unsigned char token = *ip++;
+
+        size_t lit_len = token >> 4;
+        if (lit_len == 15 && !GetLength(ip, in_end, lit_len)) return false;
+        if (static_cast<size_t>(in_end - ip) < lit_len ||
+            static_cast<size_t>(out_end - op) < lit_len) {
+            return false;
+        }
+        std::memcpy(op, ip, lit_len);
+        ip += lit_len;
+        op += lit_len;
+
+        if (ip == in_end) break; // last sequence
+
+        if (in_end - ip < 2) return false;
+        size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+
+        size_t match_len = token & 0x0F;
+        if (match_len == 15 && !GetLength(ip, in_end, match_len)) return false;
+        match_len += MIN_MATCH;
+
+        if (offset == 0 || offset > static_cast<size_t>(op - base) ||
+            static_cast<size_t>(out_end - op) < match_len) {
+            return false;
+        }
+
+        // byte by byte: the match may overlap the bytes it produces
+        const unsigned char* from = op - offset;
+        for (size_t k = 0; k < match_len; ++k) op[k] = from[k];
+        op += match_len;
+    }
+
+    return op == out_end;
+}
+
+}
@@ -0,0 +1,244 @@
+#include "storage/page/page_checksum.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define DB_CRC32C_SSE42 1
+#endif
+
+namespace db::storage {
+namespace {
+// reflected Castagnoli polynomial
+constexpr uint32_t POLY = 0x82F63B78;
+
+// the hardware path interleaves three independent crc32 streams to hide
+// the instruction's 3 cycle latency, then merges them by shifting the
+// partial crcs over the bytes that followed them. LONG and SHORT must be
+// powers of two.
+constexpr size_t LONG_BLOCK = 2048;
+constexpr size_t SHORT_BLOCK = 256;
+
+uint32_t Load32(const unsigned char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+uint64_t Load64(const unsigned char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// gf(2) matrix helpers used to build the "append n zero bytes" operator
+uint32_t MatrixTimes(const uint32_t* mat, uint32_t vec) {
+    uint32_t sum = 0;
+    while (vec) {
+        if (vec & 1) sum ^= *mat;
+        vec >>= 1;
+        ++mat;
+    }
+    return sum;
+}
+
+void MatrixSquare(uint32_t* square, const uint32_t* mat) {
+    for (int n = 0; n < 32; ++n) {
+        square[n] = MatrixTimes(mat, mat[n]);
+    }
+}
+
+// operator that appends `len` zero bytes to a raw crc register.
+// `len` must be a power of two.
+void ZerosOperator(uint32_t* even, size_t len) {
+    uint32_t odd[32];
+    odd[0] = POLY; // one zero bit
+    uint32_t row = 1;
+    for (int n = 1; n < 32; ++n) {
+        odd[n] = row;
+        row <<= 1;
+    }
+    MatrixSquare(even, odd); // two zero bits
+    MatrixSquare(odd, even); // four zero bits
+
+    // each square doubles the number of zero bits; the first one in the
+    // loop reaches a whole byte
+    do {
+        MatrixSquare(even, odd);
+        len >>= 1;
+        if (len == 0) return;
+        MatrixSquare(odd, even);
+        len >>= 1;
+    } while (len);
+    std::copy(odd, odd + 32, even);
+}
+
+struct Tables {
+    uint32_t slice[8][256];
+    uint32_t long_shift[4][256];
+    uint32_t short_shift[4][256];
+
+    Tables() {
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t crc = n;
+            for (int k = 0; k < 8; ++k) {
+                crc = (crc & 1) ? (crc >> 1) ^ POLY : crc >> 1;
+            }
+            slice[0][n] = crc;
+        }
+        for (uint32_t n = 0; n < 256; ++n) {
+            for (int k = 1; k < 8; ++k) {
+                uint32_t prev = slice[k - 1][n];
+                slice[k][n] = (prev >> 8) ^ slice[0][prev & 0xFF];
+            }
+        }
+        BuildShift(long_shift, LONG_BLOCK);
+        BuildShift(short_shift, SHORT_BLOCK);
+    }
+
+    static void BuildShift(uint32_t table[4][256], size_t len) {
+        uint32_t op[32];
+        ZerosOperator(op, len);
+        for (uint32_t n = 0; n < 256; ++n) {
+            table[0][n] = MatrixTimes(op, n);
+            table[1][n] = MatrixTimes(op, n << 8);
+            table[2][n] = MatrixTimes(op, n << 16);
+            table[3][n] = MatrixTimes(op, n << 24);
+        }
+    }
+};
+
+const Tables& GetTables() {
+    static const Tables tables;
+    return tables;
+}
+
+[[maybe_unused]] uint32_t Shift(const uint32_t table[4][256], uint32_t crc) {
+    return table[0][crc & 0xFF] ^ table[1][(crc >> 8) & 0xFF] ^
+           table[2][(crc >> 16) & 0xFF] ^ table[3][crc >> 24];
+}
+
+// slicing-by-8 on a raw (already inverted) register
+uint32_t Crc32cSoftware(uint32_t crc, const unsigned char* p, size_t len) {
+    const auto& t = GetTables().slice;
+
+    if constexpr (std::endian::native == std::endian::little) {
+        while (len >= 8) {
+            uint64_t word = Load64(p) ^ crc;
+            crc = t[7][word & 0xFF] ^ t[6][(word >> 8) & 0xFF] ^
+                  t[5][(word >> 16) & 0xFF] ^ t[4][(word >> 24) & 0xFF] ^
+                  t[3][(word >> 32) & 0xFF] ^ t[2][(word >> 40) & 0xFF] ^
+                  t[1][(word >> 48) & 0xFF] ^ t[0][word >> 56];
+            p += 8;
+            len -= 8;
+        }
+    }
+    while (len--) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    }
+    return crc;
+}
+
+#ifdef DB_CRC32C_SSE42
+__attribute__((target("sse4.2")))
+uint64_t Crc3Lanes(uint64_t crc0, const unsigned char*& p, size_t block,
+                   const uint32_t shift[4][256]) {
+    uint64_t crc1 = 0;
+    uint64_t crc2 = 0;
+    const unsigned char* end = p + block;
+    do {
+        crc0 = _mm_crc32_u64(crc0, Load64(p));
+        crc1 = _mm_crc32_u64(crc1, Load64(p + block));
+        crc2 = _mm_crc32_u64(crc2, Load64(p + 2 * block));
+        p += 8;
+    } while (p < end);
+
+    crc0 = Shift(shift, static_cast<uint32_t>(crc0)) ^ crc1;
+    crc0 = Shift(shift, static_cast<uint32_t>(crc0)) ^ crc2;
+    p += 2 * block;
+    return crc0;
+}
+
+__attribute__((target("sse4.2")))
+uint32_t Crc32cHardware(uint32_t crc, const unsigned char* p, size_t len) {
+    const Tables& tables = GetTables();
+    uint64_t crc0 = crc;
+
+    // align to 8 bytes
+    while (len && (reinterpret_cast<uintptr_t>(p) & 7)) {
+        crc0 = _mm_crc32_u8(static_cast<uint32_t>(crc0), *p++);
+        --len;
+    }
+
+    while (len >= 3 * LONG_BLOCK) {
+        crc0 = Crc3Lanes(crc0, p, LONG_BLOCK, tables.long_shift);
+        len -= 3 * LONG_BLOCK;
+    }
+    while (len >= 3 * SHORT_BLOCK) {
+        crc0 = Crc3Lanes(crc0, p, SHORT_BLOCK, tables.short_shift);
+        len -= 3 * SHORT_BLOCK;
+    }
+
+    while (len >= 8) {
+        crc0 = _mm_crc32_u64(crc0, Load64(p));
+        p += 8;
+        len -= 8;
+    }
+    while (len--) {
+        crc0 = _mm_crc32_u8(static_cast<uint32_t>(crc0), *p++);
+    }
+    return static_cast<uint32_t>(crc0);
+}
+
+bool HasSse42() {
+    static const bool has = __builtin_cpu_supports("sse4.2");
+    return has;
+}
+#endif
+
+bool IsZeroPage(const char* page) {
+    const auto* p = reinterpret_cast<const unsigned char*>(page);
+    return std::all_of(p, p + config::PAGE_SIZE,
+                       [](unsigned char c) { return c == 0; });
+}
+}
+
+uint32_t Crc32c(const void* data, size_t len, uint32_t crc) {
+    const auto* p = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+#ifdef DB_CRC32C_SSE42
+    if (HasSse42()) return ~Crc32cHardware(crc, p, len);
+#endif
+    return ~Crc32cSoftware(crc, p, len);
+}
+
+bool Crc32cHardwareAccelerated() {
+#ifdef DB_CRC32C_SSE42
+    return HasSse42();
+#else
+    return false;
+#endif
+}
+
+uint32_t ComputePageChecksum(const char* page) {
+    return Crc32c(page, PAGE_CHECKSUM_OFFSET);
+}
+
+uint32_t GetPageChecksum(const char* page) {
+    return Load32(reinterpret_cast<const unsigned char*>(page) + PAGE_CHECKSUM_OFFSET);
+}
+
+void SetPageChecksum(char* page) {
+    uint32_t crc = ComputePageChecksum(page);
+    std::memcpy(page + PAGE_CHECKSUM_OFFSET, &crc, sizeof(crc));
+}
+
+bool VerifyPageChecksum(const char* page) {
+    if (GetPageChecksum(page) == ComputePageChecksum(page)) return true;
+
+    // allocated but never written pages read back as zeroes
+    return IsZeroPage(page);
+}
+
+}
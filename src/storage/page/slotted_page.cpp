@@ -1,5 +1,6 @@
 #include "storage/page/slotted_page.h"
 #include "config/config.h"
+#include <cstring>
 
 namespace db::storage {
 
@@ -17,6 +18,8 @@ namespace db::storage {
 |        FREE SPACE      |
 +------------------------+
 | Record Data            |  grows downward
++------------------------+  <- PAGE_DATA_SIZE
+| Checksum               |
 +------------------------+  <- page end
 
 lower address               higher address
@@ -51,7 +54,7 @@ SlottedPage SlottedPage::FromBuffer(char* page_data, uint16_t offset) {
 void SlottedPage::Init(char* page_data, uint16_t offset) {
     auto* header = reinterpret_cast<PageHeader*>(page_data + offset);
     header->num_slots = 0;
-    header->free_space_offset = config::PAGE_SIZE;
+    header->free_space_offset = config::PAGE_DATA_SIZE;
 };
 
 std::optional<uint16_t> SlottedPage::Insert(const char* data, std::size_t len) {
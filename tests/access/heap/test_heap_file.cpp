@@ -1,6 +1,8 @@
 #include "access/heap/heap_file.h"
 #include "storage/buffer_manager/replacement_policies/replacement.h"
 #include <gtest/gtest.h>
+#include <filesystem>
+#include <vector>
 #include "util/uuid.h"
 namespace db::access {
 
@@ -68,4 +70,102 @@ TEST(HeapFileTest, MultiPageInsert) {
         }
     }
 }
+TEST(HeapFileTest, InsertGoesStraightToAPageWithRoom) {
+    std::filesystem::remove("heap_file_fsm.db");
+    DiskManager dm("heap_file_fsm.db");
+    BufferManager bm(db::storage::ReplacementPolicyType::CLOCK, &dm);
+
+    HeapFile hf(&bm, &dm, util::GenerateUUID(), INVALID_PAGE_ID);
+
+    // 7 of these fill a page; the first page keeps room for a small one
+    std::vector<char> big(1100, 'x');
+    std::vector<char> huge(5000, 'z');
+    auto first = hf.Insert(huge.data(), huge.size()).value();
+    for (int i = 0; i < 1400; i++) {
+        ASSERT_TRUE(hf.Insert(big.data(), big.size()).has_value());
+    }
+
+    // the free space map and the page written; no walk of 200 pages
+    auto before = bm.stats();
+    auto rid = hf.Insert("small", 6).value();
+    auto after = bm.stats();
+    EXPECT_LE(after.hits + after.misses - before.hits - before.misses, 5u);
+    EXPECT_EQ(rid.page_id, first.page_id);
+
+    // full pages are left alone, a new one is appended at the end
+    before = bm.stats();
+    auto appended = hf.Insert(huge.data(), huge.size()).value();
+    after = bm.stats();
+    EXPECT_LE(after.hits + after.misses - before.hits - before.misses, 6u);
+    EXPECT_EQ(after.new_pages - before.new_pages, 1u);
+
+    size_t records = 0;
+    page_id_t last_page = INVALID_PAGE_ID;
+    for (auto it = hf.begin(); it != hf.end(); ++it) {
+        ++records;
+        last_page = (*it).rid.page_id;
+    }
+    EXPECT_EQ(records, 1403u);
+    EXPECT_EQ(last_page, appended.page_id);
+}
+
+TEST(HeapFileTest, FreeSpaceMapIsRebuiltForOlderFiles) {
+    std::filesystem::remove("heap_file_fsm_rebuild.db");
+    DiskManager dm("heap_file_fsm_rebuild.db");
+    BufferManager bm(db::storage::ReplacementPolicyType::CLOCK, &dm);
+
+    auto fid = util::GenerateUUID();
+    auto hf = HeapFile::Create(&bm, &dm, fid);
+    std::vector<char> big(3000, 'y');
+    for (int i = 0; i < 10; i++) {
+        ASSERT_TRUE(hf.Insert(big.data(), big.size()).has_value());
+    }
+
+    // a file written before the map has 0 where its root is now kept
+    {
+        auto first = bm.write_page(hf.GetPageId());
+        reinterpret_cast<HeapPageHeader*>(first.data())->fsm_page_id = 0;
+        first.mark_dirty();
+    }
+    auto reopened = HeapFile::Open(&bm, &dm, fid, hf.GetPageId());
+    auto rid = reopened.Insert("fits", 5).value();
+    EXPECT_EQ(rid.page_id, hf.GetPageId());
+
+    // and the rebuilt map knows the end of the chain
+    auto appended = reopened.Insert(big.data(), big.size()).value();
+    size_t records = 0;
+    for (auto it = reopened.begin(); it != reopened.end(); ++it) ++records;
+    EXPECT_EQ(records, 12u);
+    EXPECT_NE(appended.page_id, rid.page_id);
+    EXPECT_TRUE(reopened.Get(appended).has_value());
+}
+TEST(HeapFileTest, FreeSpaceUpdatesLatchTheRootOnlyWhenItChanges) {
+    std::filesystem::remove("heap_file_fsm_latch.db");
+    DiskManager dm("heap_file_fsm_latch.db");
+    BufferManager bm(db::storage::ReplacementPolicyType::CLOCK, &dm);
+
+    // heap pages 100 and 101 with 3 and 100 categories of room
+    auto fid = util::GenerateUUID();
+    page_id_t root = FreeSpaceMap::Build(&bm, fid, {{100, 3 * FSM_CATEGORY_BYTES},
+                                                    {101, 100 * FSM_CATEGORY_BYTES}});
+    FreeSpaceMap fsm{&bm, fid, root};
+    auto small = fsm.Find(3 * FSM_CATEGORY_BYTES);
+    auto large = fsm.Find(50 * FSM_CATEGORY_BYTES);
+    ASSERT_TRUE(small.has_value() && large.has_value());
+    ASSERT_EQ(small->page_id, 100);
+    ASSERT_EQ(large->page_id, 101);
+
+    // the maximum of the leaf stays: a reader of the root does not block it
+    {
+        auto reader = bm.read_page(root);
+        fsm.Update(*small, 2 * FSM_CATEGORY_BYTES);
+    }
+
+    // the maximum drops: the root follows
+    fsm.Update(*large, 0);
+    EXPECT_FALSE(fsm.Find(3 * FSM_CATEGORY_BYTES).has_value());
+    auto slot = fsm.Find(2 * FSM_CATEGORY_BYTES);
+    ASSERT_TRUE(slot.has_value());
+    EXPECT_EQ(slot->page_id, 100);
+}
 };
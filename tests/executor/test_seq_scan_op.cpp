@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <filesystem>
 #include "executor/operators/seq_scan_op.h"
 #include "executor/test_db_helper.h"
 #include "catalog/catalog_bootstrap.h"
@@ -70,3 +71,47 @@ TEST(CatalogSeqScanTest, ScanAllCatalogTables) {
 
 
 
+
+TEST(SeqScanOpTest, LargeScanKeepsCatalogPagesCached) {
+    std::filesystem::remove("seq_scan_ring_test.db");
+    TestDB db{"seq_scan_ring_test.db"};
+
+    std::vector<catalog::RawColumnInfo> schema = {
+        {"id", catalog::INT_TYPE, 1},
+        {"payload", catalog::TEXT_TYPE, 2}
+    };
+    db.table_mgr->CreateTable("big", schema);
+    auto table = db.table_mgr->OpenTable("big");
+
+    // about two rows per page: the table is larger than the buffer pool.
+    // load it through a ring as well.
+    storage::BufferRing load_ring;
+    const std::string payload(3000, 'x');
+    const uint32_t rows = 2 * config::BUFFER_POOL_SIZE + 50;
+    for (uint32_t i = 0; i < rows; ++i) {
+        ASSERT_TRUE(table->Insert({Value{i}, Value{payload}}, &load_ring).has_value());
+    }
+
+    auto* bm = db.catalog->GetBm();
+    auto cached_frame = [bm](storage::page_id_t pid) {
+        storage::Frame* f = bm->request(pid);
+        bm->release(pid);
+        return f;
+    };
+    storage::page_id_t tables_page = db.catalog->GetTablesCatalog()->GetFirstPage();
+    storage::page_id_t attrs_page = db.catalog->GetAttributesCatalog()->GetFirstPage();
+    storage::Frame* tables_frame = cached_frame(tables_page);
+    storage::Frame* attrs_frame = cached_frame(attrs_page);
+
+    executor::SeqScanOp scan{*table};
+    scan.Open();
+    uint32_t count = 0;
+    while (scan.Next()) count++;
+    scan.Close();
+    EXPECT_EQ(count, rows);
+
+    EXPECT_EQ(cached_frame(tables_page), tables_frame);
+    EXPECT_EQ(cached_frame(attrs_page), attrs_frame);
+    EXPECT_EQ(tables_frame->page_id, tables_page);
+    EXPECT_TRUE(db.catalog->LookupTable("big").has_value());
+}
@@ -7,9 +7,12 @@
 namespace db::model {
 
 TEST(UserTableTest, BasicInsertFlow) {
-    DiskManager* dm = new DiskManager{"test.db"};
-    BufferManager* bm = new BufferManager{storage::ReplacementPolicyType::CLOCK, dm};
-    catalog::Catalog* cat = new catalog::Catalog{bm, dm};
+    DiskManager disk{"test.db"};
+    BufferManager buffer{storage::ReplacementPolicyType::CLOCK, &disk};
+    catalog::Catalog catalog{&buffer, &disk};
+    DiskManager* dm = &disk;
+    BufferManager* bm = &buffer;
+    catalog::Catalog* cat = &catalog;
 
     cat->Init();
     std::vector<catalog::RawColumnInfo> cols = {
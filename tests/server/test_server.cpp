@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
+#include <chrono>
 #include <filesystem>
+#include <thread>
 
 #include "server/server.h"
+#include "storage/buffer_manager/buffer_manager.h"
 #include "storage/disk_manager/disk_manager.h"
 #include "config/config.h"
 
@@ -18,7 +21,7 @@ protected:
 
         // clean up old test dbs
         for (auto& e : std::filesystem::directory_iterator(data_dir)) {
-            if (e.path().extension() == ".db") {
+            if (e.path().extension() == ".db" || e.path().extension() == ".warm") {
                 std::filesystem::remove(e.path());
             }
         }
@@ -26,7 +29,7 @@ protected:
 
     void TearDown() override {
         for (auto& e : std::filesystem::directory_iterator(data_dir)) {
-            if (e.path().extension() == ".db") {
+            if (e.path().extension() == ".db" || e.path().extension() == ".warm") {
                 std::filesystem::remove(e.path());
             }
         }
@@ -85,9 +88,140 @@ TEST_F(DbServerTest, DeleteDatabase) {
     EXPECT_EQ(dm, nullptr);
 }
 
+TEST_F(DbServerTest, DeleteDatabaseRefusesWhileAGuardIsHeld) {
+    DbServer server{8};
+    server.Init();
+    ASSERT_TRUE(server.CreateDatabase("busy"));
+    BufferManager* bm = server.GetBufferManager("busy");
+    ASSERT_NE(bm, nullptr);
+
+    // the calling thread itself holds the page
+    auto page = bm->new_page();
+    page.data()[0] = 'p';
+    EXPECT_FALSE(server.DeleteDatabase("busy"));
+    EXPECT_EQ(server.GetBufferManager("busy"), bm);
+    EXPECT_EQ(page.data()[0], 'p');
+
+    page.release();
+    EXPECT_TRUE(server.DeleteDatabase("busy"));
+    EXPECT_EQ(server.GetBufferManager("busy"), nullptr);
+}
+
 TEST_F(DbServerTest, DeleteNonExistentDatabase) {
     DbServer server;
     server.Init();
 
     EXPECT_FALSE(server.DeleteDatabase("ghost"));
 }
+
+TEST_F(DbServerTest, RestartWarmsUpTheBufferPool) {
+    std::vector<page_id_t> pages;
+    {
+        DbServer server{8};
+        server.Init();
+        ASSERT_TRUE(server.CreateDatabase("warm"));
+        BufferManager* bm = server.GetBufferManager("warm");
+        ASSERT_NE(bm, nullptr);
+        for (int i = 0; i < 3; ++i) {
+            auto page = bm->new_page();
+            page.data()[0] = static_cast<char>('a' + i);
+            pages.push_back(page.page_id());
+        }
+        // the pages are flushed and the warm set saved on shutdown
+    }
+    ASSERT_TRUE(std::filesystem::exists(config::DATA_PATH + "/warm.warm"));
+
+    DbServer server{8};
+    server.Init();
+    BufferManager* bm = server.GetBufferManager("warm");
+    ASSERT_NE(bm, nullptr);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(bm->read_page(pages[i]).data()[0], 'a' + i);
+    }
+    EXPECT_EQ(bm->stats().misses, 0u);
+    EXPECT_EQ(bm->stats().prefetches, 3u);
+
+    ASSERT_TRUE(server.DeleteDatabase("warm"));
+    EXPECT_FALSE(std::filesystem::exists(config::DATA_PATH + "/warm.warm"));
+    EXPECT_EQ(server.GetBufferManager("warm"), nullptr);
+}
+
+TEST_F(DbServerTest, OpenDatabaseWarmsUpTheBufferPool) {
+    std::vector<page_id_t> pages;
+    {
+        DbServer server{8};
+        ASSERT_TRUE(server.CreateDatabase("lazy"));
+        BufferManager* bm = server.GetBufferManager("lazy");
+        ASSERT_NE(bm, nullptr);
+        for (int i = 0; i < 3; ++i) {
+            auto page = bm->new_page();
+            page.data()[0] = static_cast<char>('x' + i);
+            pages.push_back(page.page_id());
+        }
+    }
+
+    // opened on demand rather than discovered by Init()
+    DbServer server{8};
+    EXPECT_EQ(server.GetBufferManager("lazy"), nullptr);
+    ASSERT_NE(server.OpenDatabase("lazy"), nullptr);
+    BufferManager* bm = server.GetBufferManager("lazy");
+    ASSERT_NE(bm, nullptr);
+    EXPECT_EQ(bm->stats().prefetches, 3u);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(bm->read_page(pages[i]).data()[0], 'x' + i);
+    }
+    EXPECT_EQ(bm->stats().misses, 0u);
+
+    // a second open neither reloads nor rereads
+    server.OpenDatabase("lazy");
+    EXPECT_EQ(bm->stats().prefetches, 3u);
+}
+
+TEST_F(DbServerTest, DatabasesShareOneBufferPool) {
+    DbServer server{16};
+    server.Init();
+    ASSERT_TRUE(server.CreateDatabase("one"));
+    ASSERT_TRUE(server.CreateDatabase("two"));
+    BufferManager* one = server.GetBufferManager("one");
+    BufferManager* two = server.GetBufferManager("two");
+    ASSERT_NE(one, nullptr);
+    ASSERT_NE(two, nullptr);
+    EXPECT_EQ(one->pool_size(), 16u);
+
+    page_id_t pid;
+    {
+        auto a = one->new_page();
+        a.data()[0] = '1';
+        pid = a.page_id();
+    }
+    {
+        auto b = two->new_page();
+        b.data()[0] = '2';
+        EXPECT_EQ(b.page_id(), pid); // each database numbers its own pages
+    }
+    EXPECT_EQ(one->read_page(pid).data()[0], '1');
+    EXPECT_EQ(two->read_page(pid).data()[0], '2');
+
+    EXPECT_EQ(one->stats().new_pages, 1u);
+    EXPECT_EQ(two->stats().new_pages, 1u);
+    EXPECT_EQ(server.PoolStats().new_pages, 2u);
+    EXPECT_EQ(server.PoolStats().frames, 16u);
+}
+
+TEST_F(DbServerTest, DirtyPagesAreWrittenInTheBackground) {
+    DbServer server{16};
+    server.Init();
+    ASSERT_TRUE(server.CreateDatabase("bg"));
+    BufferManager* bm = server.GetBufferManager("bg");
+    ASSERT_NE(bm, nullptr);
+    for (int i = 0; i < 4; ++i) {
+        bm->new_page().data()[0] = 'w';
+    }
+
+    // nothing is flushed; the server's writer cleans the pool
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (bm->stats().writes == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+    EXPECT_GT(bm->stats().writes, 0u);
+}
@@ -0,0 +1,165 @@
+#include "storage/buffer_manager/replacement_policies/arc_policy.h"
+#include "storage/buffer_manager/frame.h"
+#include "config/config.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+
+namespace db::storage {
+
+class ARCPolicyTest : public ::testing::Test {
+protected:
+    std::vector<Frame> pool;
+    std::vector<Frame*> frames;
+    std::unique_ptr<ARCPolicy> policy;
+
+    ARCPolicyTest() {
+        // 4 frames, references 2+ ticks apart are uncorrelated
+        pool.resize(4);
+        for (auto& f : pool) {
+            frames.push_back(&f);
+        }
+        policy = std::make_unique<ARCPolicy>(frames, 1);
+    }
+
+    // simulates the buffer manager loading `pid` into frame `idx`
+    void load(size_t idx, page_id_t pid) {
+        frames[idx]->page_id = pid;
+        policy->record_load(frames[idx]);
+    }
+
+    // simulates a page hit on frame `idx`
+    void touch(size_t idx) {
+        policy->record_access(frames[idx]);
+    }
+};
+
+// ----------------------------
+// Empty frames go first
+// ----------------------------
+TEST_F(ARCPolicyTest, PrefersFramesWithoutPage) {
+    load(0, 10);
+    load(1, 11);
+    EXPECT_EQ(policy->choose_victim(), frames[2]);
+}
+
+TEST_F(ARCPolicyTest, SkipsPinnedFramesWithoutPage) {
+    load(0, 10);
+    frames[1]->pin_count = 1;
+    EXPECT_EQ(policy->choose_victim(), frames[2]);
+
+    // once every frame holds a page, the queues decide
+    load(1, 11);
+    frames[1]->pin_count = 0;
+    load(2, 12);
+    load(3, 13);
+    EXPECT_EQ(policy->choose_victim(), frames[0]);
+}
+
+// ----------------------------
+// Pages seen once (T1) go before pages seen twice (T2)
+// ----------------------------
+TEST_F(ARCPolicyTest, EvictsFromT1WhileAboveTarget) {
+    for (size_t i = 0; i < 4; ++i) load(i, static_cast<page_id_t>(i));
+    touch(0);
+    touch(1);
+
+    // target is 0: T1 (frames 2, 3) loses its LRU page
+    EXPECT_EQ(policy->choose_victim(), frames[2]);
+}
+
+// ----------------------------
+// T2 is an LRU list
+// ----------------------------
+TEST_F(ARCPolicyTest, EvictsT2LeastRecentlyUsedWhenT1IsEmpty) {
+    for (size_t i = 0; i < 4; ++i) load(i, static_cast<page_id_t>(i));
+    touch(0);
+    touch(1);
+    touch(2);
+    touch(3);
+    touch(0);
+
+    EXPECT_EQ(policy->choose_victim(), frames[1]);
+}
+
+// ----------------------------
+// A burst of back-to-back hits does not promote
+// ----------------------------
+TEST_F(ARCPolicyTest, CorrelatedHitsStayInT1) {
+    for (size_t i = 1; i < 4; ++i) load(i, static_cast<page_id_t>(i));
+    touch(1);
+    touch(2);
+    touch(3);
+
+    // frame 0 is scanned: many hits right after its load
+    load(0, 0);
+    for (int t = 0; t < 10; ++t) touch(0);
+
+    EXPECT_EQ(policy->choose_victim(), frames[0]);
+}
+
+// ----------------------------
+// Ghost hits move the target
+// ----------------------------
+TEST_F(ARCPolicyTest, GhostHitInB1GrowsTarget) {
+    for (size_t i = 0; i < 4; ++i) load(i, static_cast<page_id_t>(i));
+    touch(2);
+    touch(3);
+    EXPECT_EQ(policy->target(), 0u);
+
+    load(0, 10); // page 0 -> B1
+    load(1, 0);  // B1 hit: T1 was too small
+    EXPECT_EQ(policy->target(), 1u);
+}
+
+TEST_F(ARCPolicyTest, GhostHitInB2ShrinksTarget) {
+    for (size_t i = 0; i < 4; ++i) load(i, static_cast<page_id_t>(i));
+    touch(2);
+    touch(3);
+    load(0, 10);
+    load(1, 0);
+    ASSERT_EQ(policy->target(), 1u);
+
+    load(2, 20); // page 2 (T2) -> B2
+    load(3, 2);  // B2 hit: T2 was too small
+    EXPECT_EQ(policy->target(), 0u);
+}
+
+// ----------------------------
+// A sequential scan does not evict hot pages
+// ----------------------------
+TEST_F(ARCPolicyTest, ScanDoesNotFlushHotPages) {
+    load(0, 0);
+    load(1, 1);
+    for (int round = 0; round < 3; ++round) {
+        touch(0);
+        touch(1);
+    }
+
+    page_id_t next_page = 100;
+    for (int i = 0; i < 20; ++i) {
+        Frame* victim = policy->choose_victim();
+        ASSERT_NE(victim, nullptr);
+        ASSERT_NE(victim, frames[0]);
+        ASSERT_NE(victim, frames[1]);
+        victim->page_id = next_page++;
+        policy->record_load(victim);
+        for (int t = 0; t < 5; ++t) policy->record_access(victim);
+    }
+}
+
+// ----------------------------
+// Pinned frames are skipped
+// ----------------------------
+TEST_F(ARCPolicyTest, NoVictimWhenAllPinned) {
+    for (size_t i = 0; i < 4; ++i) load(i, static_cast<page_id_t>(i));
+    for (auto f : frames) {
+        f->pin_count = 1;
+    }
+    EXPECT_EQ(policy->choose_victim(), nullptr);
+
+    frames[3]->pin_count = 0;
+    EXPECT_EQ(policy->choose_victim(), frames[3]);
+}
+
+}
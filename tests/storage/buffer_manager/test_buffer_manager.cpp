@@ -1,9 +1,21 @@
+#include "storage/buffer_manager/background_writer.h"
 #include "storage/buffer_manager/buffer_manager.h"
+#include "storage/disk_manager/disk_manager.h"
 #include "storage/mocks/disk_manager_mock.h"
+#include "storage/page/page_checksum.h"
 #include "config/config.h"
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <set>
+#include <thread>
+#include <vector>
 
 namespace db::storage {
 
@@ -63,9 +75,11 @@ TEST_F(BufferManagerTest, DirtyWriteAndFlushAll) {
     auto stored = disk->store[pid];
     ASSERT_EQ(stored.size(), config::PAGE_SIZE);
 
-    for (char c : stored) {
-        EXPECT_EQ(c, 'X');
+    // everything but the checksum trailer is the frame content
+    for (size_t i = 0; i < config::PAGE_DATA_SIZE; ++i) {
+        EXPECT_EQ(stored[i], 'X');
     }
+    EXPECT_TRUE(VerifyPageChecksum(stored.data()));
 }
 
 // ------------------------------------------------------------------
@@ -179,4 +193,901 @@ TEST_F(BufferManagerTest, ReleaseInvalidPageThrows) {
     EXPECT_THROW(bm->release(55555), std::runtime_error);
 }
 
+// ------------------------------------------------------------------
+// 8. Checksums are verified on read
+// ------------------------------------------------------------------
+TEST_F(BufferManagerTest, CorruptPageIsDetectedOnRead) {
+    page_id_t pid = 77;
+    Frame* f = bm->request(pid);
+    memset(f->data, 'Y', config::PAGE_DATA_SIZE);
+    bm->mark_dirty(f);
+    bm->release(pid);
+    bm->flush_all();
+
+    // flip a bit on "disk" and read it through a cold pool
+    disk->store[pid][100] ^= 0x01;
+    BufferManager cold{ReplacementPolicyType::CLOCK, disk};
+    EXPECT_THROW(cold.request(pid), std::runtime_error);
+
+    // the failed read does not leak a frame: the whole pool can be pinned
+    for (size_t i = 0; i < config::BUFFER_POOL_SIZE; i++) {
+        cold.request(5000 + i);
+    }
+    for (size_t i = 0; i < config::BUFFER_POOL_SIZE; i++) {
+        cold.release(5000 + i);
+    }
+
+    // with verification off the damaged page is returned as is
+    cold.set_verify_checksums(false);
+    Frame* corrupt = cold.request(pid);
+    EXPECT_EQ(corrupt->data[100], 'Y' ^ 0x01);
+}
+
+// ------------------------------------------------------------------
+// 9. Concurrent sessions share one pool
+// ------------------------------------------------------------------
+TEST_F(BufferManagerTest, ConcurrentRequestsSeeTheirOwnPage) {
+    // more pages than frames so threads keep evicting each other
+    constexpr page_id_t NUM_PAGES = 3 * config::BUFFER_POOL_SIZE;
+    for (page_id_t pid = 0; pid < NUM_PAGES; ++pid) {
+        std::vector<char> page(config::PAGE_SIZE, 0);
+        std::memcpy(page.data(), &pid, sizeof(pid));
+        SetPageChecksum(page.data());
+        disk->store[pid] = page;
+    }
+
+    constexpr int THREADS = 8;
+    constexpr int OPS = 2000;
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&, t] {
+            uint32_t x = 17 + t;
+            for (int i = 0; i < OPS; ++i) {
+                x = x * 1103515245 + 12345;
+                page_id_t pid = static_cast<page_id_t>((x >> 8) % NUM_PAGES);
+
+                Frame* f = bm->request(pid);
+                page_id_t stored;
+                std::memcpy(&stored, f->data, sizeof(stored));
+                if (stored != pid || f->page_id != pid) ++mismatches;
+                if (i % 7 == 0) bm->mark_dirty(f);
+                bm->release(pid);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    EXPECT_EQ(mismatches.load(), 0);
+
+    // every frame is unpinned again
+    for (size_t i = 0; i < config::BUFFER_POOL_SIZE; ++i) {
+        bm->request(100000 + i);
+    }
+}
+
+// ------------------------------------------------------------------
+// 10. Every replacement policy serves concurrent sessions
+// ------------------------------------------------------------------
+TEST_F(BufferManagerTest, EveryPolicyServesConcurrentRequests) {
+    constexpr page_id_t NUM_PAGES = 3 * config::BUFFER_POOL_SIZE;
+    for (page_id_t pid = 0; pid < NUM_PAGES; ++pid) {
+        std::vector<char> page(config::PAGE_SIZE, 0);
+        std::memcpy(page.data(), &pid, sizeof(pid));
+        SetPageChecksum(page.data());
+        disk->store[pid] = page;
+    }
+
+    for (auto type : {ReplacementPolicyType::CLOCK,
+                      ReplacementPolicyType::LRU_K,
+                      ReplacementPolicyType::TWO_Q,
+                      ReplacementPolicyType::ARC}) {
+        BufferManager pool{type, disk};
+        std::atomic<int> mismatches{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t] {
+                uint32_t x = 31 + t;
+                for (int i = 0; i < 1000; ++i) {
+                    x = x * 1103515245 + 12345;
+                    // half of the requests go to a small hot set
+                    page_id_t pid = static_cast<page_id_t>((x >> 8) % (i % 2 ? 20 : NUM_PAGES));
+
+                    Frame* f = pool.request(pid);
+                    page_id_t stored;
+                    std::memcpy(&stored, f->data, sizeof(stored));
+                    if (stored != pid || f->page_id != pid) ++mismatches;
+                    pool.release(pid);
+                }
+            });
+        }
+        for (auto& th : threads) th.join();
+
+        EXPECT_EQ(mismatches.load(), 0);
+        for (size_t i = 0; i < config::BUFFER_POOL_SIZE; ++i) {
+            pool.request(100000 + i);
+        }
+    }
+}
+
+// ------------------------------------------------------------------
+// 11. A scan through a ring recycles its own frames
+// ------------------------------------------------------------------
+TEST_F(BufferManagerTest, RingScanKeepsHotPagesCached) {
+    // hot pages, e.g. the catalog
+    for (page_id_t pid = 0; pid < 10; ++pid) {
+        bm->request(pid);
+        bm->release(pid);
+    }
+
+    BufferRing ring{8};
+    std::set<Frame*> used;
+    const page_id_t pool_size = static_cast<page_id_t>(config::BUFFER_POOL_SIZE);
+    for (page_id_t pid = 1000; pid < 1000 + 3 * pool_size; ++pid) {
+        Frame* f = bm->request(pid, &ring);
+        used.insert(f);
+        // the scan reads every page twice, like the heap iterator
+        bm->request(pid, &ring);
+        bm->release(pid);
+        bm->release(pid);
+    }
+    EXPECT_LE(used.size(), ring.size());
+
+    size_t reads = disk->reads;
+    for (page_id_t pid = 0; pid < 10; ++pid) {
+        bm->request(pid);
+        bm->release(pid);
+    }
+    EXPECT_EQ(disk->reads, reads);
+}
+
+TEST_F(BufferManagerTest, RingWritesBackPagesItRecycles) {
+    BufferRing ring{4};
+    for (page_id_t pid = 2000; pid < 2010; ++pid) {
+        Frame* f = bm->request(pid, &ring);
+        memset(f->data, static_cast<int>(pid % 100), config::PAGE_DATA_SIZE);
+        bm->mark_dirty(f);
+        bm->release(pid);
+    }
+
+    // the first six pages were recycled, so they are on disk already
+    for (page_id_t pid = 2000; pid < 2006; ++pid) {
+        ASSERT_EQ(disk->store[pid].size(), config::PAGE_SIZE);
+        EXPECT_EQ(disk->store[pid][0], static_cast<char>(pid % 100));
+        EXPECT_TRUE(VerifyPageChecksum(disk->store[pid].data()));
+    }
+}
+
+// ------------------------------------------------------------------
+// 12. Pool size is chosen at construction
+// ------------------------------------------------------------------
+TEST_F(BufferManagerTest, PoolSizeIsSetAtConstruction) {
+    BufferManager small{ReplacementPolicyType::CLOCK, disk, 8};
+    EXPECT_EQ(small.pool_size(), 8u);
+
+    for (page_id_t pid = 0; pid < 8; ++pid) {
+        small.request(pid);
+    }
+    // every frame is pinned
+    EXPECT_THROW(small.request(8), std::runtime_error);
+
+    small.release(0);
+    EXPECT_NO_THROW(small.request(8));
+}
+
+TEST_F(BufferManagerTest, EmptyPoolIsRejected) {
+    EXPECT_THROW(BufferManager(ReplacementPolicyType::CLOCK, disk, 0),
+                 std::invalid_argument);
+}
+
+TEST_F(BufferManagerTest, FramesShareOneAlignedArena) {
+    // large enough to be backed by huge pages
+    const size_t frames = 2 * config::HUGE_PAGE_SIZE / config::PAGE_SIZE;
+    BufferManager big{ReplacementPolicyType::CLOCK, disk, frames};
+
+    std::vector<char*> data;
+    for (size_t i = 0; i < frames; ++i) {
+        Frame* f = big.request(static_cast<page_id_t>(i));
+        data.push_back(f->data);
+    }
+    std::sort(data.begin(), data.end());
+
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(data[0]) % config::HUGE_PAGE_SIZE, 0u);
+    for (size_t i = 1; i < frames; ++i) {
+        EXPECT_EQ(data[i] - data[i - 1], static_cast<ptrdiff_t>(config::PAGE_SIZE));
+    }
+}
+
+// ------------------------------------------------------------------
+// 13. Dirty pages are written back ahead of eviction
+// ------------------------------------------------------------------
+TEST_F(BufferManagerTest, WriteBehindCleansUpcomingVictims) {
+    for (auto type : {ReplacementPolicyType::CLOCK, ReplacementPolicyType::LRU_K,
+                      ReplacementPolicyType::TWO_Q, ReplacementPolicyType::ARC}) {
+        BufferManager pool{type, disk, 8};
+        for (page_id_t pid = 0; pid < 8; ++pid) {
+            Frame* f = pool.request(pid);
+            memset(f->data, pid + 1, config::PAGE_DATA_SIZE);
+            pool.mark_dirty(f);
+            pool.release(pid);
+        }
+
+        // every dirty page among the next 2 victims (25% of the pool)
+        size_t writes = disk->writes;
+        EXPECT_EQ(pool.write_behind(config::BGWRITER_MAX_PAGES), 2u);
+        EXPECT_EQ(disk->writes, writes + 2);
+
+        // so the next two misses do not write anything
+        writes = disk->writes;
+        pool.request(100);
+        pool.release(100);
+        pool.request(101);
+        pool.release(101);
+        EXPECT_EQ(disk->writes, writes);
+    }
+}
+
+TEST_F(BufferManagerTest, WriteBehindKeepsToItsBudgetAndSkipsPinnedPages) {
+    BufferManager pool{ReplacementPolicyType::CLOCK, disk, 8};
+    for (page_id_t pid = 0; pid < 8; ++pid) {
+        Frame* f = pool.request(pid);
+        memset(f->data, pid + 1, config::PAGE_DATA_SIZE);
+        pool.mark_dirty(f);
+        if (pid != 0) pool.release(pid);
+    }
+
+    size_t writes = disk->writes;
+    EXPECT_EQ(pool.write_behind(1), 1u);
+    EXPECT_EQ(pool.write_behind(0), 0u);
+    EXPECT_EQ(disk->writes, writes + 1);
+
+    // page 0 is still pinned
+    EXPECT_EQ(disk->store[0][0], 0);
+    std::vector<page_id_t> written;
+    for (page_id_t pid = 1; pid < 8; ++pid) {
+        if (disk->store[pid][0] == pid + 1) {
+            written.push_back(pid);
+            EXPECT_TRUE(VerifyPageChecksum(disk->store[pid].data()));
+        }
+    }
+    EXPECT_EQ(written.size(), 1u);
+}
+
+TEST_F(BufferManagerTest, BackgroundWriterTricklesDirtyPages) {
+    BufferManager pool{ReplacementPolicyType::CLOCK, disk, 8};
+    for (page_id_t pid = 0; pid < 8; ++pid) {
+        Frame* f = pool.request(pid);
+        pool.mark_dirty(f);
+        pool.release(pid);
+    }
+
+    {
+        BackgroundWriter writer{&pool, std::chrono::milliseconds{1}};
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+        while (writer.pages_written() < 2 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        EXPECT_GE(writer.pages_written(), 2u);
+    }
+
+    size_t writes = disk->writes;
+    pool.request(100);
+    pool.release(100);
+    EXPECT_EQ(disk->writes, writes);
+}
+
+// ------------------------------------------------------------------
+// 14. Prefetched pages are read before they are requested
+// ------------------------------------------------------------------
+TEST_F(BufferManagerTest, PrefetchCachesPagesUnpinned) {
+    bm->request(60);
+    bm->release(60);
+
+    size_t reads = disk->reads;
+    bm->prefetch(59, 4); // 60 is cached already
+    EXPECT_EQ(disk->reads, reads + 3);
+
+    for (page_id_t pid = 59; pid < 63; ++pid) {
+        Frame* f = bm->request(pid);
+        EXPECT_EQ(f->page_id, pid);
+        EXPECT_EQ(f->pin_count, 1);
+        bm->release(pid);
+    }
+    EXPECT_EQ(disk->reads, reads + 3);
+}
+
+TEST_F(BufferManagerTest, PrefetchIsOnlyAHint) {
+    BufferManager small{ReplacementPolicyType::CLOCK, disk, 2};
+    small.request(0);
+    small.request(1);
+
+    // every frame is pinned
+    EXPECT_NO_THROW(small.prefetch(2, 4));
+    small.release(0);
+    small.release(1);
+}
+
+TEST_F(BufferManagerTest, PrefetchThroughARingRecyclesItsFrames) {
+    for (page_id_t pid = 0; pid < 10; ++pid) {
+        bm->request(pid);
+        bm->release(pid);
+    }
+
+    BufferRing ring{8};
+    const page_id_t pool_size = static_cast<page_id_t>(config::BUFFER_POOL_SIZE);
+    for (page_id_t pid = 1000; pid < 1000 + 3 * pool_size; pid += 4) {
+        bm->prefetch(pid, 4, &ring);
+        for (page_id_t p = pid; p < pid + 4; ++p) {
+            bm->request(p, &ring);
+            bm->release(p);
+        }
+    }
+
+    size_t reads = disk->reads;
+    for (page_id_t pid = 0; pid < 10; ++pid) {
+        bm->request(pid);
+        bm->release(pid);
+    }
+    EXPECT_EQ(disk->reads, reads);
+}
+
+TEST_F(BufferManagerTest, PrefetchReadsInTheBackground) {
+    const char* file = "bm_prefetch.db";
+    std::filesystem::remove(file);
+    // prefetches are read on the DiskManager's I/O thread
+    DiskManager dm{file};
+    for (page_id_t pid = 0; pid < 64; ++pid) {
+        dm.AllocatePage();
+    }
+    {
+        BufferManager writer{ReplacementPolicyType::CLOCK, &dm, 64};
+        for (page_id_t pid = 0; pid < 64; ++pid) {
+            Frame* f = writer.request(pid);
+            memset(f->data, 'a' + pid % 26, config::PAGE_DATA_SIZE);
+            writer.mark_dirty(f);
+            writer.release(pid);
+        }
+        writer.flush_all();
+    }
+
+    BufferManager pool{ReplacementPolicyType::CLOCK, &dm, 32};
+    for (page_id_t pid = 0; pid < 64; pid += 8) {
+        pool.prefetch(pid, 8);
+        for (page_id_t p = pid; p < pid + 8; ++p) {
+            Frame* f = pool.request(p);
+            EXPECT_EQ(f->data[0], 'a' + p % 26) << "page " << p;
+            pool.release(p);
+        }
+    }
+
+    // reads still in flight are waited for
+    BufferManager dropped{ReplacementPolicyType::CLOCK, &dm, 8};
+    dropped.prefetch(0, 8);
+}
+
+// ------------------------------------------------------------------
+// 15. New pages are not read from disk
+// ------------------------------------------------------------------
+TEST_F(BufferManagerTest, NewPageSkipsTheRead) {
+    size_t reads = disk->reads;
+    page_id_t pid;
+    {
+        auto page = bm->new_page();
+        pid = page.page_id();
+        EXPECT_EQ(std::count(page.data(), page.data() + config::PAGE_SIZE, 0),
+                  static_cast<long>(config::PAGE_SIZE));
+        page.data()[0] = 'n';
+    }
+    EXPECT_EQ(disk->reads, reads);
+    EXPECT_EQ(bm->stats().new_pages, 1u);
+
+    // dirty without mark_dirty(), so the page reaches the disk
+    bm->flush_all();
+    ASSERT_EQ(disk->store[pid].size(), config::PAGE_SIZE);
+    EXPECT_EQ(disk->store[pid][0], 'n');
+}
+
+TEST_F(BufferManagerTest, NewPageReplacesAStaleCopy) {
+    page_id_t pid = bm->new_page().page_id();
+
+    // the next page id is cached already, e.g. by a read-ahead
+    Frame* stale = bm->request(pid + 1);
+    memset(stale->data, 's', config::PAGE_DATA_SIZE);
+    bm->release(pid + 1);
+
+    auto page = bm->new_page();
+    ASSERT_EQ(page.page_id(), pid + 1);
+    EXPECT_EQ(page.data(), stale->data);
+    EXPECT_EQ(page.data()[0], 0);
+    EXPECT_EQ(stale->pin_count, 1);
+}
+
+// ------------------------------------------------------------------
+// 16. Dirty page table
+// ------------------------------------------------------------------
+TEST_F(BufferManagerTest, DirtyPageTableKeepsTheFirstChange) {
+    for (page_id_t pid : {30, 10, 20}) {
+        bm->mark_dirty(bm->request(pid));
+        bm->release(pid);
+    }
+    {
+        // a later change of page 10 does not move its entry
+        auto page = bm->write_page(10);
+        page.mark_dirty();
+    }
+
+    auto dpt = bm->dirty_page_table();
+    ASSERT_EQ(dpt.size(), 3u);
+    EXPECT_EQ(dpt[0].first, 10);
+    EXPECT_EQ(dpt[1].first, 20);
+    EXPECT_EQ(dpt[2].first, 30);
+    EXPECT_LT(dpt[2].second, dpt[0].second); // 30 was dirtied first
+    EXPECT_LT(dpt[0].second, dpt[1].second);
+}
+
+TEST_F(BufferManagerTest, FlushAllWritesTheDirtyPagesInPageOrder) {
+    for (page_id_t pid : {7, 3, 5, 1, 2}) {
+        Frame* f = bm->request(pid);
+        if (pid != 2) bm->mark_dirty(f);
+        bm->release(pid);
+    }
+
+    disk->write_order.clear();
+    bm->flush_all();
+    EXPECT_EQ(disk->write_order, (std::vector<page_id_t>{1, 3, 5, 7}));
+    EXPECT_TRUE(bm->dirty_page_table().empty());
+
+    // a page dirtied again gets a new entry
+    bm->mark_dirty(bm->request(3));
+    bm->release(3);
+    ASSERT_EQ(bm->dirty_page_table().size(), 1u);
+}
+
+TEST_F(BufferManagerTest, EvictionRemovesDirtyPageTableEntries) {
+    BufferManager small{ReplacementPolicyType::CLOCK, disk, 1};
+    small.mark_dirty(small.request(0));
+    small.release(0);
+    ASSERT_EQ(small.dirty_page_table().size(), 1u);
+
+    small.request(100);
+    small.release(100);
+    EXPECT_TRUE(small.dirty_page_table().empty());
+}
+
+TEST_F(BufferManagerTest, FlushAllWaitsForAWriteBehindInFlight) {
+    // holds the first write; records whether a sync came before it landed
+    struct SlowDisk : MockDiskManager {
+        std::promise<void> entered;
+        std::promise<void> go;
+        std::atomic<bool> first{true};
+        std::atomic<bool> landed{false};
+        std::atomic<bool> synced_early{false};
+        void WritePage(page_id_t pid, const char* data) override {
+            if (first.exchange(false)) {
+                entered.set_value();
+                go.get_future().wait();
+            }
+            MockDiskManager::WritePage(pid, data);
+            landed = true;
+        }
+        void Sync() override {
+            if (!landed) synced_early = true;
+        }
+    } slow;
+
+    BufferManager small{ReplacementPolicyType::LRU_K, &slow, 8};
+    Frame* f = small.request(0);
+    f->data[0] = 'w';
+    small.mark_dirty(f);
+    small.release(0);
+
+    std::thread writer{[&] { small.write_behind(config::BGWRITER_MAX_PAGES); }};
+    slow.entered.get_future().wait();
+
+    // the page is not on disk yet, so it is still dirty for a checkpoint
+    EXPECT_EQ(small.dirty_page_table().size(), 1u);
+    auto flushed = std::async(std::launch::async, [&] { small.flush_all(); });
+    EXPECT_EQ(flushed.wait_for(std::chrono::milliseconds{50}), std::future_status::timeout);
+
+    slow.go.set_value();
+    writer.join();
+    flushed.get();
+    EXPECT_FALSE(slow.synced_early);
+    EXPECT_EQ(slow.store[0][0], 'w');
+    EXPECT_TRUE(small.dirty_page_table().empty());
+}
+
+TEST_F(BufferManagerTest, EvictionWritesWithoutTheShardLatch) {
+    // holds the first write until the test lets it go
+    struct SlowDisk : MockDiskManager {
+        std::promise<void> entered;
+        std::promise<void> go;
+        std::atomic<bool> first{true};
+        void WritePage(page_id_t pid, const char* data) override {
+            if (first.exchange(false)) {
+                entered.set_value();
+                go.get_future().wait();
+            }
+            MockDiskManager::WritePage(pid, data);
+        }
+    } slow;
+
+    // both pages in the same page table shard
+    const page_id_t cold = 0;
+    const page_id_t hot = static_cast<page_id_t>(config::BUFFER_POOL_SHARDS);
+    BufferManager small{ReplacementPolicyType::LRU_K, &slow, 2};
+    Frame* f = small.request(cold);
+    f->data[0] = 'c';
+    small.mark_dirty(f);
+    small.release(cold);
+    small.request(hot);
+    small.release(hot);
+
+    std::thread evictor{[&] {
+        small.request(hot + 1);
+        small.release(hot + 1);
+    }};
+    slow.entered.get_future().wait();
+
+    // a hit in the victim's shard does not wait for the write
+    auto hit = std::async(std::launch::async, [&] {
+        small.request(hot);
+        small.release(hot);
+    });
+    EXPECT_EQ(hit.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+    // a request for the victim waits for it and reads what was written
+    auto reread = std::async(std::launch::async, [&] {
+        char c = small.request(cold)->data[0];
+        small.release(cold);
+        return c;
+    });
+    slow.go.set_value();
+    evictor.join();
+    hit.wait();
+    EXPECT_EQ(reread.get(), 'c');
+}
+
+// ------------------------------------------------------------------
+// 17. Optimistic reads
+// ------------------------------------------------------------------
+TEST_F(BufferManagerTest, OptimisticReadNeedsNoPin) {
+    PageHint hint{4};
+    EXPECT_FALSE(bm->try_read_optimistic(hint, [](const char*) {})); // not cached
+
+    {
+        auto page = bm->write_page(4);
+        page.data()[0] = 'o';
+        page.mark_dirty();
+    }
+    char seen = 0;
+    EXPECT_TRUE(bm->try_read_optimistic(hint, [&](const char* data) {
+        seen = data[0];
+        EXPECT_EQ(hint.frame->pin_count, 0);
+    }));
+    EXPECT_EQ(seen, 'o');
+    EXPECT_EQ(hint.frame, bm->request(4));
+    bm->release(4);
+}
+
+TEST_F(BufferManagerTest, OptimisticReadFailsIfThePageChanged) {
+    PageHint hint{4};
+    bm->request(4);
+    bm->release(4);
+
+    // a writer in the middle of the read
+    EXPECT_FALSE(bm->try_read_optimistic(hint, [this](const char*) {
+        auto page = bm->write_page(4);
+        page.data()[0] = 'w';
+    }));
+
+    // a writer holding the page
+    {
+        auto page = bm->write_page(4);
+        EXPECT_FALSE(bm->try_read_optimistic(hint, [](const char*) {}));
+    }
+    EXPECT_TRUE(bm->try_read_optimistic(hint, [](const char*) {}));
+}
+
+TEST_F(BufferManagerTest, OptimisticReadFailsAfterEviction) {
+    BufferManager small{ReplacementPolicyType::CLOCK, disk, 1};
+    {
+        auto page = small.write_page(0);
+        page.data()[0] = 'e';
+        page.mark_dirty();
+    }
+    PageHint hint{0};
+    ASSERT_TRUE(small.try_read_optimistic(hint, [](const char*) {}));
+
+    small.request(1);
+    small.release(1);
+    EXPECT_FALSE(small.try_read_optimistic(hint, [](const char*) {}));
+    EXPECT_EQ(hint.frame, nullptr);
+
+    // the fallback reads the page back in
+    char seen = 0;
+    small.read_optimistic(hint, [&](const char* data) { seen = data[0]; });
+    EXPECT_EQ(seen, 'e');
+    EXPECT_NE(hint.frame, nullptr);
+}
+
+TEST_F(BufferManagerTest, OptimisticReadersNeverAcceptATornPage) {
+    constexpr int WRITES = 2000;
+    bm->request(9);
+    bm->release(9);
+
+    std::atomic<bool> done = false;
+    std::thread writer{[&] {
+        for (int i = 1; i <= WRITES; ++i) {
+            auto page = bm->write_page(9);
+            std::memset(page.data(), i % 128, config::PAGE_DATA_SIZE);
+        }
+        done = true;
+    }};
+
+    std::vector<std::thread> readers;
+    std::atomic<int> torn = 0;
+    for (int t = 0; t < 3; ++t) {
+        readers.emplace_back([&] {
+            PageHint hint{9};
+            while (!done) {
+                char first = 0;
+                char last = 0;
+                bm->read_optimistic(hint, [&](const char* data) {
+                    first = data[0];
+                    last = data[config::PAGE_DATA_SIZE - 1];
+                });
+                if (first != last) ++torn;
+            }
+        });
+    }
+    writer.join();
+    for (auto& t : readers) t.join();
+    EXPECT_EQ(torn, 0);
+}
+
+// ------------------------------------------------------------------
+// 18. Warm sets survive a restart
+// ------------------------------------------------------------------
+TEST_F(BufferManagerTest, WarmUpReloadsTheSavedPages) {
+    const std::string path = "bm_warm_set.bin";
+    for (page_id_t pid : {5, 1, 3}) {
+        bm->request(pid);
+        bm->release(pid);
+    }
+    EXPECT_EQ(bm->save_warm_set(path), 3u);
+
+    BufferManager restarted{ReplacementPolicyType::CLOCK, disk, 8};
+    size_t reads = disk->reads;
+    EXPECT_EQ(restarted.warm_up(path), 3u);
+    for (page_id_t pid : {1, 3, 5}) {
+        restarted.request(pid);
+        restarted.release(pid);
+    }
+    EXPECT_EQ(disk->reads, reads + 3);
+    EXPECT_EQ(restarted.stats().misses, 0u);
+    EXPECT_EQ(restarted.stats().prefetches, 3u);
+    std::filesystem::remove(path);
+}
+
+TEST_F(BufferManagerTest, WarmUpPrefersReferencedPagesAndNeverEvicts) {
+    const std::string path = "bm_warm_set.bin";
+    BufferManager big{ReplacementPolicyType::TWO_Q, disk, 8};
+    for (page_id_t pid = 10; pid < 14; ++pid) {
+        big.request(pid);
+        big.release(pid);
+    }
+    for (page_id_t pid = 20; pid < 26; ++pid) {
+        big.request(pid);
+        big.release(pid);
+    }
+    // 10 was evicted from A1in; coming back moves it to Am
+    big.request(10);
+    big.release(10);
+    big.save_warm_set(path);
+
+    BufferManager small{ReplacementPolicyType::CLOCK, disk, 1};
+    small.request(99); // keeps the only frame busy
+    EXPECT_EQ(small.warm_up(path), 0u);
+    small.release(99);
+
+    BufferManager one{ReplacementPolicyType::CLOCK, disk, 1};
+    EXPECT_EQ(one.warm_up(path), 1u);
+    one.request(10);
+    one.release(10);
+    EXPECT_EQ(one.stats().misses, 0u);
+    std::filesystem::remove(path);
+}
+
+TEST_F(BufferManagerTest, WarmUpWithoutAWarmSet) {
+    EXPECT_EQ(bm->warm_up("no_such_warm_set.bin"), 0u);
+
+    const std::string path = "bm_warm_set.bin";
+    {
+        std::ofstream out{path, std::ios::binary};
+        out << "garbage";
+    }
+    EXPECT_THROW(bm->warm_up(path), std::runtime_error);
+    std::filesystem::remove(path);
+}
+
+// ------------------------------------------------------------------
+// 19. One pool shared by several databases
+// ------------------------------------------------------------------
+TEST_F(BufferManagerTest, ViewsShareThePoolAndKeepTheirPageIds) {
+    MockDiskManager other;
+    BufferManager pool{ReplacementPolicyType::CLOCK, nullptr, 4};
+    BufferManager a{pool, disk};
+    BufferManager b{pool, &other};
+    {
+        auto pa = a.write_page(1);
+        auto pb = b.write_page(1);
+        EXPECT_EQ(pa.page_id(), 1);
+        EXPECT_NE(pa.data(), pb.data());
+        pa.data()[0] = 'a';
+        pb.data()[0] = 'b';
+        pa.mark_dirty();
+        pb.mark_dirty();
+    }
+    auto fresh = b.new_page();
+    page_id_t fresh_pid = fresh.page_id();
+    fresh.data()[0] = 'n';
+    fresh.release();
+
+    ASSERT_EQ(a.dirty_page_table().size(), 1u);
+    EXPECT_EQ(a.dirty_page_table()[0].first, 1);
+    a.flush_all();
+    EXPECT_EQ(disk->store[1][0], 'a');
+    EXPECT_EQ(other.store[1][0], 0); // b's page is still dirty
+    b.flush_all();
+    EXPECT_EQ(other.store[1][0], 'b');
+    EXPECT_EQ(other.store[fresh_pid][0], 'n');
+
+    EXPECT_EQ(a.read_page(1).data()[0], 'a');
+    EXPECT_EQ(b.read_page(1).data()[0], 'b');
+    EXPECT_EQ(pool.stats().misses, 2u);
+}
+
+TEST_F(BufferManagerTest, ViewStatsCountTheirOwnPages) {
+    MockDiskManager other;
+    BufferManager pool{ReplacementPolicyType::CLOCK, nullptr, 8};
+    BufferManager a{pool, disk};
+    BufferManager b{pool, &other};
+    for (page_id_t pid = 0; pid < 3; ++pid) {
+        a.request(pid);
+        a.release(pid);
+    }
+    b.request(0);
+    b.release(0);
+    b.request(0);
+    b.release(0);
+
+    EXPECT_EQ(a.stats().frames, 3u);
+    EXPECT_EQ(a.stats().misses, 3u);
+    EXPECT_EQ(a.stats().reads, 3u);
+    EXPECT_EQ(b.stats().frames, 1u);
+    EXPECT_EQ(b.stats().misses, 1u);
+    EXPECT_EQ(b.stats().hits, 1u);
+    EXPECT_EQ(pool.stats().misses, 4u);
+    EXPECT_EQ(pool.stats().frames, 8u);
+}
+
+TEST_F(BufferManagerTest, ABusyDatabaseLeavesTheReserveOfAnIdleOne) {
+    MockDiskManager other;
+    // LRU-2 would evict the idle database's older pages first
+    BufferManager pool{ReplacementPolicyType::LRU_K, nullptr, 8};
+    BufferManager busy{pool, disk};
+    BufferManager idle{pool, &other};
+    // 8 frames * 50% / 2 databases: 2 frames are reserved for each
+    for (page_id_t pid = 0; pid < 3; ++pid) {
+        idle.request(pid);
+        idle.release(pid);
+    }
+    for (page_id_t pid = 0; pid < 20; ++pid) {
+        busy.request(pid);
+        busy.release(pid);
+    }
+    EXPECT_EQ(idle.stats().frames, 2u);
+    EXPECT_EQ(idle.stats().evictions, 1u);
+    EXPECT_EQ(busy.stats().frames, 6u);
+}
+
+TEST_F(BufferManagerTest, DroppingAViewFreesItsFrames) {
+    MockDiskManager other;
+    BufferManager pool{ReplacementPolicyType::CLOCK, nullptr, 4};
+    BufferManager a{pool, disk};
+    {
+        BufferManager b{pool, &other};
+        for (page_id_t pid = 0; pid < 4; ++pid) {
+            b.request(pid);
+            b.release(pid);
+        }
+    }
+    for (page_id_t pid = 0; pid < 4; ++pid) {
+        a.request(pid);
+        a.release(pid);
+    }
+    EXPECT_EQ(pool.stats().evictions, 0u);
+    EXPECT_EQ(a.stats().frames, 4u);
+}
+
+TEST_F(BufferManagerTest, DroppingAViewWaitsForItsPinnedPages) {
+    MockDiskManager other;
+    BufferManager pool{ReplacementPolicyType::CLOCK, nullptr, 4};
+    BufferManager a{pool, disk};
+    auto b = std::make_unique<BufferManager>(pool, &other);
+    a.request(0);
+    a.release(0);
+    b->request(0);
+    b->release(0);
+
+    auto guard = b->read_page(1);
+    EXPECT_TRUE(b->has_pinned_pages());
+    EXPECT_FALSE(a.has_pinned_pages());
+
+    std::atomic<bool> dropped{false};
+    std::thread dropper{[&] {
+        b.reset();
+        dropped = true;
+    }};
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    EXPECT_FALSE(dropped);
+
+    guard.release();
+    dropper.join();
+    for (page_id_t pid = 1; pid < 4; ++pid) {
+        a.request(pid);
+        a.release(pid);
+    }
+    EXPECT_EQ(pool.stats().evictions, 0u);
+}
+
+TEST_F(BufferManagerTest, WarmUpsOfViewsDoNotWaitForEachOther) {
+    const std::string path = "bm_warm_set.bin";
+    for (page_id_t pid : {1, 2}) {
+        bm->request(pid);
+        bm->release(pid);
+    }
+    ASSERT_EQ(bm->save_warm_set(path), 2u);
+
+    // holds every read until the test lets it go
+    struct SlowDisk : MockDiskManager {
+        std::shared_future<void> go;
+        void ReadPage(page_id_t pid, char* out) override {
+            go.wait();
+            MockDiskManager::ReadPage(pid, out);
+        }
+    } slow;
+    std::promise<void> go;
+    slow.go = go.get_future().share();
+
+    BufferManager pool{ReplacementPolicyType::CLOCK, nullptr, 8};
+    BufferManager a{pool, &slow};
+    BufferManager b{pool, disk};
+    EXPECT_EQ(a.warm_up(path), 2u);
+    auto queued = std::async(std::launch::async, [&] { return b.warm_up(path); });
+    EXPECT_EQ(queued.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+    go.set_value();
+    EXPECT_EQ(queued.get(), 2u);
+    for (page_id_t pid : {1, 2}) {
+        a.request(pid);
+        a.release(pid);
+        b.request(pid);
+        b.release(pid);
+    }
+    EXPECT_EQ(a.stats().misses, 0u);
+    EXPECT_EQ(b.stats().misses, 0u);
+    std::filesystem::remove(path);
+}
+
+TEST_F(BufferManagerTest, ViewsNeedASharedPool) {
+    EXPECT_THROW((BufferManager{*bm, disk}), std::invalid_argument);
+
+    BufferManager pool{ReplacementPolicyType::CLOCK, nullptr, 4};
+    BufferManager view{pool, disk};
+    EXPECT_THROW(view.request(page_id_t{1} << DatabaseDisks::DATABASE_PAGE_BITS), std::out_of_range);
+    EXPECT_THROW(pool.new_page(), std::logic_error);
+}
+
 }
@@ -0,0 +1,113 @@
+#include "storage/buffer_manager/buffer_manager.h"
+#include "storage/buffer_manager/buffer_stats.h"
+#include "storage/mocks/disk_manager_mock.h"
+#include "config/config.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+namespace db::storage {
+
+TEST(HistogramTest, BucketsArePowersOfTwo) {
+    EXPECT_EQ(Histogram::bucket_of(0), 0u);
+    EXPECT_EQ(Histogram::bucket_of(1), 1u);
+    EXPECT_EQ(Histogram::bucket_of(3), 2u);
+    EXPECT_EQ(Histogram::bucket_of(4), 3u);
+    EXPECT_EQ(Histogram::bucket_of(UINT64_MAX), Histogram::BUCKETS - 1);
+}
+
+TEST(HistogramTest, PercentilesAreBucketBounds) {
+    AtomicHistogram latencies;
+    for (int i = 0; i < 99; ++i) {
+        latencies.record(std::chrono::microseconds{10}); // [8, 16)
+    }
+    latencies.record(std::chrono::milliseconds{1}); // [512, 1024)
+
+    Histogram h;
+    latencies.snapshot(h);
+    EXPECT_EQ(h.count, 100u);
+    EXPECT_DOUBLE_EQ(h.mean_us(), (99 * 10 + 1000) / 100.0);
+    EXPECT_EQ(h.percentile_us(50), 16u);
+    EXPECT_EQ(h.percentile_us(99), 16u);
+    EXPECT_EQ(h.percentile_us(100), 1024u);
+    EXPECT_EQ(Histogram{}.percentile_us(50), 0u);
+}
+
+class BufferStatsTest : public ::testing::Test {
+protected:
+    MockDiskManager disk;
+    BufferManager bm{ReplacementPolicyType::CLOCK, &disk, 4};
+};
+
+TEST_F(BufferStatsTest, CountsHitsMissesAndEvictions) {
+    for (page_id_t pid = 0; pid < 4; ++pid) {
+        Frame* f = bm.request(pid);
+        if (pid != 0) bm.mark_dirty(f);
+        bm.release(pid);
+    }
+    bm.request(0);
+    bm.release(0);
+
+    BufferPoolStats s = bm.stats();
+    EXPECT_EQ(s.frames, 4u);
+    EXPECT_EQ(s.misses, 4u);
+    EXPECT_EQ(s.hits, 1u);
+    EXPECT_EQ(s.reads, 4u);
+    EXPECT_EQ(s.evictions, 0u);
+    EXPECT_DOUBLE_EQ(s.hit_ratio(), 0.2);
+    EXPECT_EQ(s.miss_latency.count, 4u);
+
+    // every new page evicts one; dirty victims are written first
+    for (page_id_t pid = 10; pid < 14; ++pid) {
+        bm.request(pid);
+        bm.release(pid);
+    }
+    s = bm.stats();
+    EXPECT_EQ(s.misses, 8u);
+    EXPECT_EQ(s.evictions, 4u);
+    EXPECT_GE(s.dirty_evictions, 1u);
+    EXPECT_EQ(s.writes, s.dirty_evictions);
+}
+
+TEST_F(BufferStatsTest, CountsCheckpointWritesAndPrefetches) {
+    for (page_id_t pid = 0; pid < 3; ++pid) {
+        bm.mark_dirty(bm.request(pid));
+        bm.release(pid);
+    }
+    bm.flush_all();
+    bm.prefetch(3, 1);
+
+    BufferPoolStats s = bm.stats();
+    EXPECT_EQ(s.writes, 3u);
+    EXPECT_EQ(s.reads, 4u);
+    EXPECT_EQ(s.prefetches, 1u);
+}
+
+TEST_F(BufferStatsTest, TimesContendedLatches) {
+    auto writer = bm.write_page(1);
+    std::thread reader{[this] { bm.read_page(1); }};
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    writer.release();
+    reader.join();
+
+    Histogram waits = bm.stats().latch_wait;
+    EXPECT_EQ(waits.count, 1u);
+    EXPECT_GE(waits.total_us, 10'000u);
+
+    // uncontended guards are not timed
+    bm.read_page(1);
+    EXPECT_EQ(bm.stats().latch_wait.count, 1u);
+}
+
+TEST_F(BufferStatsTest, TextDumpNamesEveryCounter) {
+    bm.request(0);
+    bm.release(0);
+    std::string text = bm.stats().to_string();
+    for (const char* field : {"4 frames", "1 misses", "hit ratio 0.0%", "evictions: 0",
+                              "reads: 1", "writes: 0", "miss latency: 1", "latch waits: 0"}) {
+        EXPECT_NE(text.find(field), std::string::npos) << field << " in\n" << text;
+    }
+}
+
+}
@@ -0,0 +1,110 @@
+#include "storage/buffer_manager/buffer_manager.h"
+#include "storage/buffer_manager/buffer_trace.h"
+#include "storage/mocks/disk_manager_mock.h"
+#include "config/config.h"
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace db::storage {
+
+class BufferTraceTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        std::filesystem::remove(path);
+    }
+
+    std::vector<TraceRecord> ReadAll() {
+        std::vector<TraceRecord> out;
+        TraceReader reader{path};
+        TraceRecord rec;
+        while (reader.next(rec)) out.push_back(rec);
+        return out;
+    }
+
+    const std::string path = "bm_trace.bin";
+    MockDiskManager disk;
+    BufferManager bm{ReplacementPolicyType::CLOCK, &disk, 4};
+};
+
+TEST_F(BufferTraceTest, RecordsRequestsAndReleasesInOrder) {
+    bm.request(1);
+    bm.release(1); // before the trace: not recorded
+
+    bm.start_trace(path);
+    bm.request(2);
+    bm.request(3);
+    bm.release(3);
+    { auto page = bm.read_page(4); }
+    bm.release(2);
+    bm.stop_trace();
+
+    bm.request(5); // after the trace
+    bm.release(5);
+
+    auto recs = ReadAll();
+    const std::vector<std::pair<page_id_t, TraceOp>> expected = {
+        {2, TraceOp::REQUEST}, {3, TraceOp::REQUEST}, {3, TraceOp::RELEASE},
+        {4, TraceOp::REQUEST}, {4, TraceOp::RELEASE}, {2, TraceOp::RELEASE},
+    };
+    ASSERT_EQ(recs.size(), expected.size());
+    for (size_t i = 0; i < recs.size(); ++i) {
+        EXPECT_EQ(recs[i].page_id, expected[i].first) << i;
+        EXPECT_EQ(recs[i].op, expected[i].second) << i;
+        if (i > 0) {
+            EXPECT_GE(recs[i].micros, recs[i - 1].micros);
+        }
+    }
+}
+
+TEST_F(BufferTraceTest, RecordsAreCompact) {
+    bm.start_trace(path);
+    for (page_id_t pid = 0; pid < 3; ++pid) {
+        bm.request(pid);
+        bm.release(pid);
+    }
+    bm.stop_trace();
+    EXPECT_EQ(std::filesystem::file_size(path), sizeof(TRACE_MAGIC) + 6 * TRACE_RECORD_SIZE);
+}
+
+TEST_F(BufferTraceTest, LongTracesAreWrittenInBatches) {
+    const size_t n = config::TRACE_BUFFER_RECORDS + 10;
+    bm.start_trace(path);
+    for (size_t i = 0; i < n; ++i) {
+        bm.request(0);
+        bm.release(0);
+    }
+    bm.stop_trace();
+    EXPECT_EQ(ReadAll().size(), 2 * n);
+}
+
+TEST_F(BufferTraceTest, OnlyOneTraceAtATime) {
+    bm.start_trace(path);
+    EXPECT_THROW(bm.start_trace(path), std::runtime_error);
+    bm.stop_trace();
+    bm.stop_trace(); // no-op
+    EXPECT_THROW(bm.start_trace("no_such_dir/trace.bin"), std::runtime_error);
+}
+
+TEST_F(BufferTraceTest, ReaderRejectsOtherFilesAndStopsAtATornRecord) {
+    {
+        std::ofstream out{path, std::ios::binary};
+        out << "not a trace";
+    }
+    EXPECT_THROW(TraceReader{path}, std::runtime_error);
+
+    bm.start_trace(path);
+    bm.request(7);
+    bm.release(7);
+    bm.stop_trace();
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+
+    auto recs = ReadAll();
+    ASSERT_EQ(recs.size(), 1u);
+    EXPECT_EQ(recs[0].page_id, 7);
+}
+
+}
@@ -111,4 +111,23 @@ TEST_F(ClockPolicyTest, NoVictimWhenAllPinned) {
     EXPECT_EQ(victim, nullptr);
 }
 
+// ----------------------------
+// Upcoming victims follow the hand
+// ----------------------------
+TEST_F(ClockPolicyTest, UpcomingVictimsFollowTheHand) {
+    for (int i = 0; i < 4; i++) {
+        pool[i].page_id = i;
+    }
+    policy->advance_hand();
+    policy->record_access(frames[2]); // second chance
+    frames[3]->pin_count = 1;
+
+    std::vector<Frame*> upcoming;
+    policy->upcoming_victims(4, upcoming);
+    EXPECT_EQ(upcoming, (std::vector<Frame*>{frames[1], frames[0], frames[2]}));
+
+    // nothing changes
+    EXPECT_EQ(policy->choose_victim(), frames[1]);
+}
+
 }
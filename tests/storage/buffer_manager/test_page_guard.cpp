@@ -0,0 +1,121 @@
+#include "storage/buffer_manager/buffer_manager.h"
+#include "storage/mocks/disk_manager_mock.h"
+#include "config/config.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace db::storage {
+
+class PageGuardTest : public ::testing::Test {
+protected:
+    MockDiskManager disk;
+    BufferManager bm{ReplacementPolicyType::CLOCK, &disk, 8};
+};
+
+TEST_F(PageGuardTest, GuardUnpinsWhenItGoesAway) {
+    Frame* f = bm.request(1);
+    bm.release(1);
+
+    {
+        auto page = bm.read_page(1);
+        EXPECT_TRUE(page.valid());
+        EXPECT_EQ(page.page_id(), 1);
+        EXPECT_EQ(page.data(), f->data);
+        EXPECT_EQ(f->pin_count, 1);
+    }
+    EXPECT_EQ(f->pin_count, 0);
+
+    auto page = bm.write_page(1);
+    page.release();
+    EXPECT_FALSE(page.valid());
+    EXPECT_EQ(f->pin_count, 0);
+    EXPECT_TRUE(f->latch.try_lock());
+    f->latch.unlock();
+}
+
+TEST_F(PageGuardTest, MovingAGuardKeepsOnePin) {
+    auto a = bm.read_page(1);
+    ReadPageGuard b{std::move(a)};
+    EXPECT_FALSE(a.valid());
+    EXPECT_EQ(b.page_id(), 1);
+
+    // assigning releases the page the target held
+    Frame* f2 = bm.request(2);
+    bm.release(2);
+    ReadPageGuard c = bm.read_page(2);
+    EXPECT_EQ(f2->pin_count, 1);
+    c = std::move(b);
+    EXPECT_EQ(f2->pin_count, 0);
+    EXPECT_EQ(c.page_id(), 1);
+}
+
+TEST_F(PageGuardTest, WriteGuardMarksDirty) {
+    {
+        auto page = bm.write_page(3);
+        std::memset(page.data(), 'w', config::PAGE_DATA_SIZE);
+        page.mark_dirty();
+    }
+    bm.flush_all();
+    EXPECT_EQ(disk.store[3][0], 'w');
+}
+
+TEST_F(PageGuardTest, ReadersShareAPage) {
+    auto first = bm.read_page(4);
+
+    std::atomic<bool> done = false;
+    std::thread reader{[&] {
+        auto second = bm.read_page(4);
+        done = true;
+    }};
+    reader.join();
+    EXPECT_TRUE(done);
+}
+
+TEST_F(PageGuardTest, WriterWaitsForReaders) {
+    auto reader = bm.read_page(5);
+
+    std::atomic<bool> wrote = false;
+    std::thread writer{[&] {
+        auto page = bm.write_page(5);
+        page.data()[0] = 'x';
+        page.mark_dirty();
+        wrote = true;
+    }};
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    EXPECT_FALSE(wrote);
+    EXPECT_EQ(reader.data()[0], 0);
+
+    reader.release();
+    writer.join();
+    EXPECT_TRUE(wrote);
+    EXPECT_EQ(bm.read_page(5).data()[0], 'x');
+}
+
+TEST_F(PageGuardTest, ConcurrentWritersDoNotLoseUpdates) {
+    constexpr int THREADS = 4;
+    constexpr int INCREMENTS = 500;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < INCREMENTS; ++i) {
+                auto page = bm.write_page(6);
+                auto* counter = reinterpret_cast<int*>(page.data());
+                ++*counter;
+                page.mark_dirty();
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    auto page = bm.read_page(6);
+    EXPECT_EQ(*reinterpret_cast<const int*>(page.data()), THREADS * INCREMENTS);
+}
+
+}
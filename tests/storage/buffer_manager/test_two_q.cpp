@@ -0,0 +1,144 @@
+#include "storage/buffer_manager/replacement_policies/two_q_policy.h"
+#include "storage/buffer_manager/frame.h"
+#include "config/config.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+
+namespace db::storage {
+
+class TwoQPolicyTest : public ::testing::Test {
+protected:
+    std::vector<Frame> pool;
+    std::vector<Frame*> frames;
+    std::unique_ptr<TwoQPolicy> policy;
+
+    TwoQPolicyTest() {
+        // 4 frames, A1in holds 1 of them, A1out remembers 4 page ids
+        pool.resize(4);
+        for (auto& f : pool) {
+            frames.push_back(&f);
+        }
+        policy = std::make_unique<TwoQPolicy>(frames, 1, 4);
+    }
+
+    // simulates the buffer manager loading `pid` into frame `idx`
+    void load(size_t idx, page_id_t pid) {
+        frames[idx]->page_id = pid;
+        policy->record_load(frames[idx]);
+    }
+
+    // simulates a page hit on frame `idx`
+    void touch(size_t idx) {
+        policy->record_access(frames[idx]);
+    }
+
+    // loads pages 0..3, then makes pages 0 and 1 hot by evicting and
+    // reloading them. afterwards frames 0, 1 hold pages 10, 11 in A1in
+    // and frames 2, 3 hold pages 0, 1 in Am.
+    void make_hot_pages() {
+        for (size_t i = 0; i < 4; ++i) load(i, static_cast<page_id_t>(i));
+        load(0, 10);
+        load(1, 11);
+        load(2, 0);
+        load(3, 1);
+    }
+};
+
+// ----------------------------
+// Empty frames go first
+// ----------------------------
+TEST_F(TwoQPolicyTest, PrefersFramesWithoutPage) {
+    load(0, 10);
+    load(1, 11);
+    EXPECT_EQ(policy->choose_victim(), frames[2]);
+}
+
+TEST_F(TwoQPolicyTest, SkipsPinnedFramesWithoutPage) {
+    load(0, 10);
+    frames[1]->pin_count = 1;
+    EXPECT_EQ(policy->choose_victim(), frames[2]);
+
+    // once every frame holds a page, the queues decide
+    load(1, 11);
+    frames[1]->pin_count = 0;
+    load(2, 12);
+    load(3, 13);
+    EXPECT_EQ(policy->choose_victim(), frames[0]);
+}
+
+// ----------------------------
+// A1in is a FIFO that ignores hits
+// ----------------------------
+TEST_F(TwoQPolicyTest, A1inEvictsInLoadOrder) {
+    for (size_t i = 0; i < 4; ++i) load(i, static_cast<page_id_t>(i));
+    touch(0);
+    touch(0);
+
+    EXPECT_EQ(policy->choose_victim(), frames[0]);
+}
+
+// ----------------------------
+// A page loaded again while in A1out is hot
+// ----------------------------
+TEST_F(TwoQPolicyTest, ReloadFromA1outPromotesToAm) {
+    for (size_t i = 0; i < 4; ++i) load(i, static_cast<page_id_t>(i));
+
+    load(0, 10);  // page 0 -> A1out
+    load(1, 0);   // page 0 -> Am
+
+    // A1in (frames 0, 2, 3) is over its share, frame 1 is protected
+    EXPECT_EQ(policy->choose_victim(), frames[2]);
+}
+
+// ----------------------------
+// Am is an LRU list
+// ----------------------------
+TEST_F(TwoQPolicyTest, AmEvictsLeastRecentlyUsed) {
+    make_hot_pages();
+    load(0, 2);   // page 2 is in A1out, so A1in shrinks to frame 1
+
+    // A1in is within its share now: take the LRU end of Am
+    EXPECT_EQ(policy->choose_victim(), frames[2]);
+    touch(2);
+    EXPECT_EQ(policy->choose_victim(), frames[3]);
+}
+
+// ----------------------------
+// A sequential scan does not evict hot pages
+// ----------------------------
+TEST_F(TwoQPolicyTest, ScanDoesNotFlushHotPages) {
+    make_hot_pages();
+
+    page_id_t next_page = 100;
+    for (int i = 0; i < 20; ++i) {
+        Frame* victim = policy->choose_victim();
+        ASSERT_NE(victim, nullptr);
+        ASSERT_NE(victim, frames[2]);
+        ASSERT_NE(victim, frames[3]);
+        victim->page_id = next_page++;
+        policy->record_load(victim);
+        for (int t = 0; t < 5; ++t) policy->record_access(victim);
+    }
+}
+
+// ----------------------------
+// Pinned frames are skipped, in either queue
+// ----------------------------
+TEST_F(TwoQPolicyTest, FallsBackToAmWhenA1inIsPinned) {
+    make_hot_pages();
+    frames[0]->pin_count = 1;
+    frames[1]->pin_count = 1;
+
+    EXPECT_EQ(policy->choose_victim(), frames[2]);
+}
+
+TEST_F(TwoQPolicyTest, NoVictimWhenAllPinned) {
+    make_hot_pages();
+    for (auto f : frames) {
+        f->pin_count = 1;
+    }
+    EXPECT_EQ(policy->choose_victim(), nullptr);
+}
+
+}
@@ -0,0 +1,82 @@
+#include "storage/disk_manager/lz_codec.h"
+#include "config/config.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace db::storage {
+namespace {
+std::vector<char> RoundTrip(const std::vector<char>& in, size_t* compressed = nullptr) {
+    std::vector<char> packed(in.size() + in.size() / 255 + 16);
+    size_t len = LZCompress(in.data(), in.size(), packed.data(), packed.size());
+    EXPECT_GT(len, 0u);
+    if (compressed) *compressed = len;
+
+    std::vector<char> out(in.size());
+    EXPECT_TRUE(LZDecompress(packed.data(), len, out.data(), out.size()));
+    return out;
+}
+}
+
+TEST(LZCodecTest, ZeroPageCompressesToAFewBytes) {
+    std::vector<char> page(config::PAGE_SIZE, 0);
+    size_t len = 0;
+    EXPECT_EQ(RoundTrip(page, &len), page);
+    EXPECT_LT(len, 64u);
+}
+
+TEST(LZCodecTest, SparseSlottedPage) {
+    // header at the front, records packed at the back, a gap in between
+    std::vector<char> page(config::PAGE_SIZE, 0);
+    std::mt19937 rng{7};
+    for (size_t i = 0; i < 64; ++i) page[i] = static_cast<char>(rng());
+    for (size_t i = config::PAGE_SIZE - 1500; i < config::PAGE_SIZE; ++i) {
+        page[i] = static_cast<char>('a' + rng() % 4);
+    }
+
+    size_t len = 0;
+    EXPECT_EQ(RoundTrip(page, &len), page);
+    EXPECT_LT(len, config::PAGE_SIZE / 2);
+}
+
+TEST(LZCodecTest, IncompressibleDataRoundTrips) {
+    std::vector<char> page(config::PAGE_SIZE);
+    std::mt19937 rng{1};
+    for (char& c : page) c = static_cast<char>(rng());
+    EXPECT_EQ(RoundTrip(page), page);
+}
+
+TEST(LZCodecTest, SmallInputs) {
+    for (size_t n : {0, 1, 3, 4, 5, 19}) {
+        std::vector<char> in(n, 'x');
+        EXPECT_EQ(RoundTrip(in), in);
+    }
+}
+
+TEST(LZCodecTest, ReportsOutputThatDoesNotFit) {
+    std::vector<char> page(config::PAGE_SIZE);
+    std::mt19937 rng{3};
+    for (char& c : page) c = static_cast<char>(rng());
+
+    std::vector<char> packed(config::PAGE_SIZE / 2);
+    EXPECT_EQ(LZCompress(page.data(), page.size(), packed.data(), packed.size()), 0u);
+}
+
+TEST(LZCodecTest, RejectsMalformedInput) {
+    std::vector<char> page(config::PAGE_SIZE, 'q');
+    std::vector<char> packed(config::PAGE_SIZE);
+    size_t len = LZCompress(page.data(), page.size(), packed.data(), packed.size());
+    ASSERT_GT(len, 0u);
+
+    std::vector<char> out(config::PAGE_SIZE);
+    // truncated input, wrong output size
+    EXPECT_FALSE(LZDecompress(packed.data(), len / 2, out.data(), out.size()));
+    EXPECT_FALSE(LZDecompress(packed.data(), len, out.data(), out.size() - 1));
+
+    // offset pointing before the start of the output
+    const char bad[] = {0x00, 0x10, 0x00};
+    EXPECT_FALSE(LZDecompress(bad, sizeof(bad), out.data(), out.size()));
+}
+
+}
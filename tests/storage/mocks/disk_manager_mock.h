@@ -2,6 +2,8 @@
 
 #include "storage/disk_manager/idisk_manager.h"
 #include "config/config.h"
+#include <atomic>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 #include <cstring>
@@ -11,24 +13,35 @@ namespace db::storage {
 class MockDiskManager : public IDiskManager {
 public:
     std::unordered_map<page_id_t, std::vector<char>> store;
+    std::mutex mu;
+    std::atomic<size_t> reads{0};
+    std::atomic<size_t> writes{0};
+    std::vector<page_id_t> write_order;
 
     void ReadPage(page_id_t pid, char* out) override {
+        std::lock_guard<std::mutex> lock{mu};
+        reads++;
         auto& buf = store[pid];
         if (buf.empty()) buf.resize(config::PAGE_SIZE, 0);
         memcpy(out, buf.data(), config::PAGE_SIZE);
     }
 
     void WritePage(page_id_t pid, const char* data) override {
+        std::lock_guard<std::mutex> lock{mu};
+        writes++;
+        write_order.push_back(pid);
         auto& buf = store[pid];
         buf.assign(data, data + config::PAGE_SIZE);
     }
 
     page_id_t AllocatePage() override {
-        static page_id_t next = 0;
+        static std::atomic<page_id_t> next = 0;
         return next++;
     }
 
     void DeallocatePage(page_id_t) override {}
+
+    void Sync() override {}
 };
 
 }
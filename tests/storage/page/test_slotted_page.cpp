@@ -27,7 +27,7 @@ TEST_F(SlottedPageTest, InitSetsHeaderCorrectly) {
     auto* header = reinterpret_cast<PageHeader*>(page);
 
     EXPECT_EQ(header->num_slots, 0);
-    EXPECT_EQ(header->free_space_offset, config::PAGE_SIZE);
+    EXPECT_EQ(header->free_space_offset, config::PAGE_DATA_SIZE);
     EXPECT_GT(sp.FreeSpace(), 0u);
 }
 